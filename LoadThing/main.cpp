@@ -1,11 +1,71 @@
-#include <windows.h>
+#include "shared_library.h"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <thread>
 
-using function = void(*)();
+using function = void (*)();
 
-int main() {
-    auto lib = LoadLibraryA("code.dll");
+#ifdef _WIN32
+static const char* default_library = "code.dll";
+#else
+static const char* default_library = "./code.so";
+#endif
 
-    auto ptr = (function)GetProcAddress(lib, "do_thing");
+static double to_ms(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static bool run_entry(SharedLibrary& library, const char* entry) {
+    auto ptr = library.function<function>(entry);
+    if (ptr == nullptr) {
+        fprintf(stderr, "%s isn't exported\n", entry);
+        return false;
+    }
+    fprintf(
+          stderr,
+          "load %.3f ms, resolve %.3f ms (load #%llu)\n",
+          to_ms(library.stats().last_load),
+          to_ms(library.stats().last_resolve),
+          (unsigned long long) library.stats().loads);
 
     ptr();
-}
\ No newline at end of file
+    fflush(stdout);
+    return true;
+}
+
+// usage: LoadThing [--watch] [library] [entry]
+//
+// With --watch the library is reloaded, and the entry point called again, every time the file changes.
+int main(int argc, char** argv) {
+    bool watch        = false;
+    const char* path  = default_library;
+    const char* entry = "do_thing";
+    int positional    = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--watch") == 0) {
+            watch = true;
+        } else if (positional++ == 0) {
+            path = argv[i];
+        } else {
+            entry = argv[i];
+        }
+    }
+
+    try {
+        SharedLibrary library(path);
+        if (!run_entry(library, entry)) {
+            return 1;
+        }
+
+        while (watch) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (library.reload_if_changed()) {
+                run_entry(library, entry);
+            }
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
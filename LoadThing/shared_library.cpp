@@ -0,0 +1,121 @@
+#include "shared_library.h"
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <dlfcn.h>
+#endif
+
+namespace fs = std::filesystem;
+using Clock  = std::chrono::steady_clock;
+
+#ifdef _WIN32
+
+static void* open_library(const fs::path& path) {
+    return LoadLibraryW(path.c_str());
+}
+
+static void close_library(void* handle) {
+    FreeLibrary(static_cast<HMODULE>(handle));
+}
+
+static void* find_symbol(void* handle, const char* name) {
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(handle), name));
+}
+
+#else
+
+static void* open_library(const fs::path& path) {
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+
+static void close_library(void* handle) {
+    dlclose(handle);
+}
+
+static void* find_symbol(void* handle, const char* name) {
+    return dlsym(handle, name);
+}
+
+#endif
+
+SharedLibrary::SharedLibrary(fs::path path) : path_(std::move(path)) {
+    if (!load(current_version())) {
+        throw std::runtime_error("can't load " + path_.string());
+    }
+}
+
+SharedLibrary::~SharedLibrary() {
+    unload();
+}
+
+SharedLibrary::FileVersion SharedLibrary::current_version() const {
+    std::error_code error;
+    FileVersion version;
+    version.write_time = fs::last_write_time(path_, error);
+    version.size       = fs::file_size(path_, error);
+    return version;
+}
+
+bool SharedLibrary::reload_if_changed() {
+    FileVersion version = current_version();
+    if (version == loaded_version_) {
+        return false;
+    }
+    return load(version);
+}
+
+bool SharedLibrary::load(const FileVersion& version) {
+    auto start = Clock::now();
+
+    fs::path copy = path_;
+    copy.replace_extension("live" + std::to_string(generation_++) + path_.extension().string());
+
+    std::error_code error;
+    if (!fs::copy_file(path_, copy, fs::copy_options::overwrite_existing, error)) {
+        return false;
+    }
+    void* handle = open_library(copy);
+    if (handle == nullptr) {
+        fs::remove(copy, error);
+        return false;
+    }
+
+    unload();
+    handle_          = handle;
+    loaded_path_     = copy;
+    loaded_version_  = version;
+    stats_.last_load = Clock::now() - start;
+    stats_.loads++;
+    return true;
+}
+
+void SharedLibrary::unload() {
+    if (handle_ == nullptr) {
+        return;
+    }
+    close_library(handle_);
+    handle_ = nullptr;
+    symbols_.clear();
+
+    std::error_code error;
+    fs::remove(loaded_path_, error);
+}
+
+void* SharedLibrary::symbol(const std::string& name) {
+    auto found = symbols_.find(name);
+    if (found != symbols_.end()) {
+        return found->second;
+    }
+
+    auto start          = Clock::now();
+    void* address       = find_symbol(handle_, name.c_str());
+    stats_.last_resolve = Clock::now() - start;
+    stats_.resolves++;
+
+    symbols_.emplace(name, address);
+    return address;
+}
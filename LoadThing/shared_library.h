@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+struct LoadStats {
+    std::chrono::nanoseconds last_load{};
+    std::chrono::nanoseconds last_resolve{};
+    uint64_t loads    = 0;
+    uint64_t resolves = 0;
+};
+
+// A compiled Jerry library (code.dll / code.so) that can be swapped while the host keeps running.
+//
+// The file is never opened in place: every load copies it next to the original under a new name first. That
+// keeps Windows from locking the file the compiler wants to overwrite, and makes sure dlopen doesn't hand back
+// the image it already has mapped for that path.
+class SharedLibrary {
+public:
+    explicit SharedLibrary(std::filesystem::path path);
+    ~SharedLibrary();
+
+    SharedLibrary(const SharedLibrary&) = delete;
+    SharedLibrary& operator=(const SharedLibrary&) = delete;
+
+    // Loads the library again if the file changed since the last load. If the new file can't be loaded (for
+    // example because it's still being written) the old one stays in use and this returns false.
+    bool reload_if_changed();
+
+    // Cached until the next reload; nullptr if the library doesn't export `name`.
+    void* symbol(const std::string& name);
+
+    template <typename T>
+    T function(const std::string& name) {
+        return reinterpret_cast<T>(symbol(name));
+    }
+
+    const LoadStats& stats() const {
+        return stats_;
+    }
+
+private:
+    struct FileVersion {
+        std::filesystem::file_time_type write_time{};
+        uintmax_t size = 0;
+
+        bool operator==(const FileVersion& other) const {
+            return write_time == other.write_time && size == other.size;
+        }
+    };
+
+    bool load(const FileVersion& version);
+    void unload();
+    FileVersion current_version() const;
+
+    std::filesystem::path path_;
+    std::filesystem::path loaded_path_;
+    void* handle_ = nullptr;
+    FileVersion loaded_version_;
+    uint64_t generation_ = 0;
+
+    std::unordered_map<std::string, void*> symbols_;
+    LoadStats stats_;
+};
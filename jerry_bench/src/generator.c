@@ -0,0 +1,101 @@
+#include "generator.h"
+
+typedef struct Generator {
+    const GeneratorOptions* options;
+    uint64 random_state;
+
+    char* text;
+    size_t size;
+    size_t capacity;
+} Generator;
+
+// splitmix64; good enough to keep the programs from being too regular, and the same on every platform.
+static uint64 next_random(Generator* generator) {
+    uint64 z = (generator->random_state += 0x9E3779B97F4A7C15ull);
+    z        = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z        = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint32 random_below(Generator* generator, uint32 bound) {
+    return (uint32) (next_random(generator) % bound);
+}
+
+static void append(Generator* generator, const char* text, size_t size) {
+    if (generator->size + size > generator->capacity) {
+        generator->capacity = max(generator->size + size, generator->capacity * 2);
+        generator->text     = my_realloc(generator->text, generator->capacity);
+    }
+    memcpy(generator->text + generator->size, text, size);
+    generator->size += size;
+}
+
+static void append_string(Generator* generator, const char* text) {
+    append(generator, text, strlen(text));
+}
+
+// `prefix` and the index, then '_' up to the identifier length. The padding never looks like a digit, so two
+// indices can't end up with the same name.
+static void append_identifier(Generator* generator, char prefix, uint32 index) {
+    char name[32];
+    int size = snprintf(name, sizeof(name), "%c%u", prefix, index);
+    append(generator, name, (size_t) size);
+    for (uint32 i = (uint32) size; i < generator->options->identifier_length; ++i) {
+        append(generator, "_", 1);
+    }
+}
+
+// Operands are literals or any of the `variables` declared before this statement.
+static void append_expression(Generator* generator, uint32 depth, uint32 variables) {
+    if (depth == 0) {
+        if (variables > 0 && random_below(generator, 4) != 0) {
+            append_identifier(generator, 'v', random_below(generator, variables));
+        } else {
+            char number[16];
+            int size = snprintf(number, sizeof(number), "%u", random_below(generator, 1000));
+            append(generator, number, (size_t) size);
+        }
+        return;
+    }
+
+    // No division: codegen doesn't lower it yet.
+    static const char* operators[] = { " + ", " - ", " * " };
+    append_expression(generator, depth - 1, variables);
+    append_string(generator, operators[random_below(generator, array_size(operators))]);
+    append_expression(generator, depth - 1, variables);
+}
+
+static void append_function(Generator* generator, uint32 index) {
+    append_string(generator, "fn ");
+    append_identifier(generator, 'f', index);
+    append_string(generator, "() -> u64 {\n");
+
+    uint32 statements = generator->options->statements;
+    for (uint32 i = 0; i < statements; ++i) {
+        append_string(generator, "    let ");
+        append_identifier(generator, 'v', i);
+        append_string(generator, " = ");
+        append_expression(generator, generator->options->expression_depth, i);
+        append_string(generator, ";\n");
+    }
+
+    append_string(generator, "    return ");
+    if (statements > 0) {
+        append_identifier(generator, 'v', statements - 1);
+    } else {
+        append_string(generator, "0");
+    }
+    append_string(generator, ";\n}\n\n");
+}
+
+char* generate_program(const GeneratorOptions* options, size_t* size) {
+    Generator generator = { .options = options, .random_state = options->seed, .size = 0, .capacity = 4096 };
+    generator.text      = my_malloc(generator.capacity);
+
+    for (uint32 i = 0; i < options->functions; ++i) {
+        append_function(&generator, i);
+    }
+
+    *size = generator.size;
+    return generator.text;
+}
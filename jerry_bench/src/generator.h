@@ -0,0 +1,18 @@
+#pragma once
+
+#include "common.h"
+
+typedef struct GeneratorOptions {
+    uint32 functions;
+    // `let`s in every function, before its `return`.
+    uint32 statements;
+    // Every `let` is initialized with a full tree of binary operators this deep, so 2^depth operands.
+    uint32 expression_depth;
+    // Names of functions and variables are padded to this many characters.
+    uint32 identifier_length;
+    uint64 seed;
+} GeneratorOptions;
+
+// A Jerry program made of `functions` functions returning u64, which the whole compiler accepts. The same options
+// always give the same program. The caller frees the result; `size` gets its length.
+char* generate_program(const GeneratorOptions* options, size_t* size);
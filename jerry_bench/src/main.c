@@ -0,0 +1,52 @@
+#include "phase_bench.h"
+#include "scan_bench.h"
+
+static void usage() {
+    fprintf(
+          stderr,
+          "usage: jerry_bench scan [megabytes]\n"
+          "       jerry_bench generate [functions] [statements] [depth] [identifier length] > file.jerry\n"
+          "       jerry_bench phases [functions] [statements] [depth] [identifier length]\n");
+    exit(1);
+}
+
+static uint32 number_argument(int argc, char** argv, int index, uint32 fallback) {
+    return argc > index ? (uint32) atol(argv[index]) : fallback;
+}
+
+static GeneratorOptions parse_generator_options(int argc, char** argv) {
+    GeneratorOptions options;
+    options.functions         = number_argument(argc, argv, 2, 1000);
+    options.statements        = number_argument(argc, argv, 3, 20);
+    options.expression_depth  = number_argument(argc, argv, 4, 3);
+    options.identifier_length = number_argument(argc, argv, 5, 8);
+    options.seed              = 1;
+    return options;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+    }
+
+    if (strcmp(argv[1], "scan") == 0) {
+        size_t megabytes = argc > 2 ? (size_t) atol(argv[2]) : 64;
+        run_scan_bench(megabytes * 1024 * 1024);
+        return 0;
+    }
+    if (strcmp(argv[1], "generate") == 0) {
+        GeneratorOptions options = parse_generator_options(argc, argv);
+        size_t size;
+        char* text = generate_program(&options, &size);
+        fwrite(text, 1, size, stdout);
+        my_free(text);
+        return 0;
+    }
+    if (strcmp(argv[1], "phases") == 0) {
+        GeneratorOptions options = parse_generator_options(argc, argv);
+        run_phase_bench(&options);
+        return 0;
+    }
+
+    usage();
+}
@@ -0,0 +1,147 @@
+#include "phase_bench.h"
+#include "codegen.h"
+#include "lexer.h"
+#include "parser.h"
+
+enum { PHASE_BENCH_REPEATS = 5 };
+
+static const char* codegen_bench_output = "jerry_bench_output.o";
+
+// Best time of the repeats, and what one repeat got through.
+typedef struct BenchResult {
+    uint64 best_ns;
+    uint64 items;
+} BenchResult;
+
+static void print_result(const char* name, const BenchResult* result, const char* unit) {
+    double items_per_second = (double) result->items * 1e9 / (double) result->best_ns;
+    printf(
+          "%-14s %10.3f ms %12llu %-9s %14.0f %s/s\n",
+          name,
+          (double) result->best_ns / 1e6,
+          (unsigned long long) result->items,
+          unit,
+          items_per_second,
+          unit);
+}
+
+static size_t count_expr_nodes(const Expr* expr) {
+    switch (expr->kind) {
+    case EXPR_BINARY:
+        return 1 + count_expr_nodes(((const BinaryExpr*) expr)->left) +
+               count_expr_nodes(((const BinaryExpr*) expr)->right);
+    case EXPR_UNARY:
+        return 1 + count_expr_nodes(((const UnaryExpr*) expr)->subexpression);
+    case EXPR_PAREN:
+        return 1 + count_expr_nodes(((const ParenExpr*) expr)->subexpression);
+    default:
+        return 1;
+    }
+}
+
+static size_t count_stmt_nodes(const Stmt* stmt) {
+    switch (stmt->kind) {
+    case STMT_VAR_ASSIGN:
+        return 1 + count_expr_nodes(((const VariableAssignment*) stmt)->init);
+    case STMT_RETURN: {
+        const Expr* subexpr = ((const ReturnStmt*) stmt)->subexpr;
+        return 1 + (subexpr ? count_expr_nodes(subexpr) : 0);
+    }
+    default:
+        return 1;
+    }
+}
+
+// Items, statements and expressions.
+static size_t count_ast_nodes(const AstContext* ast) {
+    size_t nodes = ast->items_size;
+    for (size_t i = 0; i < ast->items_size; ++i) {
+        const Block* block = ((const FunctionItem*) ast->items[i])->block;
+        for (size_t j = 0; j < block->stmts_size; ++j) {
+            nodes += count_stmt_nodes(block->stmts[j]);
+        }
+    }
+    return nodes;
+}
+
+static BenchResult bench_lex(const char* text, size_t size) {
+    BenchResult result = { .best_ns = (uint64) -1, .items = 0 };
+    for (size_t i = 0; i < PHASE_BENCH_REPEATS; ++i) {
+        uint64 start       = time_now_ns();
+        VectorToken tokens = parse_tokens(text, size, NULL);
+        result.best_ns     = min(result.best_ns, time_now_ns() - start);
+        result.items       = tokens.size;
+        delete_vector(&tokens);
+    }
+    return result;
+}
+
+static void parse_text(AstContext* ast, const char* text, size_t size) {
+    Lexer lexer;
+    lexer_create_text(&lexer, text, size);
+    ast_context_create(ast);
+    parse(ast, &lexer);
+    lexer_delete(&lexer);
+}
+
+// Lexing is pulled by the parser, so it's in here too, along with type fixing.
+static BenchResult bench_parse(const char* text, size_t size) {
+    BenchResult result = { .best_ns = (uint64) -1, .items = 0 };
+    for (size_t i = 0; i < PHASE_BENCH_REPEATS; ++i) {
+        AstContext ast;
+        uint64 start = time_now_ns();
+        parse_text(&ast, text, size);
+        result.best_ns = min(result.best_ns, time_now_ns() - start);
+        result.items   = count_ast_nodes(&ast);
+        ast_context_delete(&ast);
+    }
+    return result;
+}
+
+// Building IR, the passes for `opt_level` and writing an object file.
+static BenchResult bench_codegen(const AstContext* ast, uint32 opt_level) {
+    CodeGenOptions options;
+    memset(&options, 0, sizeof(options));
+    options.jobs        = 1;
+    options.opt_level   = opt_level;
+    options.emit        = EMIT_OBJECT;
+    options.output_path = codegen_bench_output;
+
+    BenchResult result = { .best_ns = (uint64) -1, .items = ast->items_size };
+    for (size_t i = 0; i < PHASE_BENCH_REPEATS; ++i) {
+        uint64 start     = time_now_ns();
+        CodeGen* codegen = codegen_create(ast, &options);
+        codegen_run(codegen);
+        codegen_delete(codegen);
+        result.best_ns = min(result.best_ns, time_now_ns() - start);
+    }
+    remove(codegen_bench_output);
+    return result;
+}
+
+void run_phase_bench(const GeneratorOptions* options) {
+    size_t size;
+    char* text = generate_program(options, &size);
+    printf(
+          "%u functions, %u statements, depth %u, identifiers of %u: %zu bytes\n",
+          options->functions,
+          options->statements,
+          options->expression_depth,
+          options->identifier_length,
+          size);
+
+    BenchResult lex    = bench_lex(text, size);
+    BenchResult parsed = bench_parse(text, size);
+
+    AstContext ast;
+    parse_text(&ast, text, size);
+    BenchResult codegen_o0 = bench_codegen(&ast, 0);
+    BenchResult codegen_o2 = bench_codegen(&ast, 2);
+    ast_context_delete(&ast);
+    my_free(text);
+
+    print_result("lex", &lex, "tokens");
+    print_result("parse", &parsed, "nodes");
+    print_result("codegen -O0", &codegen_o0, "functions");
+    print_result("codegen -O2", &codegen_o2, "functions");
+}
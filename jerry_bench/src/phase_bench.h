@@ -0,0 +1,6 @@
+#pragma once
+
+#include "generator.h"
+
+// Generates a program from `options` and times the lexer, the parser and codegen on it, in items per second.
+void run_phase_bench(const GeneratorOptions* options);
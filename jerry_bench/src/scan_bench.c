@@ -0,0 +1,77 @@
+#include "scan_bench.h"
+#include "scan.h"
+
+typedef size_t (*ScanFunction)(const char* text, size_t offset, size_t size);
+
+enum { SCAN_BENCH_REPEATS = 5 };
+
+// Fills `buffer` with runs of `run_length` bytes taken from `alphabet`, each run followed by `separator`.
+static void fill_runs(char* buffer, size_t size, size_t run_length, const char* alphabet, char separator) {
+    size_t alphabet_size = strlen(alphabet);
+    for (size_t i = 0; i < size; ++i) {
+        size_t in_run = i % (run_length + 1);
+        buffer[i]     = in_run == run_length ? separator : alphabet[(i * 7) % alphabet_size];
+    }
+}
+
+// Scans the whole buffer run by run and returns the sum of the run ends, so the kernels can be checked
+// against each other and the work can't be optimized away.
+static uint64 scan_all(ScanFunction scan, const char* buffer, size_t size) {
+    uint64 checksum = 0;
+    size_t offset   = 0;
+    while (offset < size) {
+        offset = scan(buffer, offset, size);
+        checksum += offset;
+        offset++;
+    }
+    return checksum;
+}
+
+static void bench_one(const char* what, ScanFunction scan, const char* buffer, size_t size, size_t run_length) {
+    uint64 expected = 0;
+    for (ScanKernel kernel = SCAN_SCALAR; kernel < SCAN_KERNEL_SIZE; ++kernel) {
+        if (kernel > scan_best_kernel()) {
+            break;
+        }
+        scan_set_kernel(kernel);
+
+        uint64 best     = (uint64) -1;
+        uint64 checksum = 0;
+        for (size_t i = 0; i < SCAN_BENCH_REPEATS; ++i) {
+            uint64 start = time_now_ns();
+            checksum     = scan_all(scan, buffer, size);
+            best         = min(best, time_now_ns() - start);
+        }
+
+        if (kernel == SCAN_SCALAR) {
+            expected = checksum;
+        }
+        bail_out_if(checksum == expected, "scan kernels disagree");
+
+        double gigabytes_per_second = (double) size / (double) best;
+        printf(
+              "%-6s run=%-4zu %-7s %8.3f ms %7.2f GB/s\n",
+              what,
+              run_length,
+              scan_kernel_name(kernel),
+              (double) best / 1e6,
+              gigabytes_per_second);
+    }
+    scan_set_kernel(scan_best_kernel());
+}
+
+void run_scan_bench(size_t buffer_size) {
+    const size_t run_lengths[] = { 1, 4, 16, 64, 256 };
+    const char* ident_alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+
+    char* buffer = my_malloc(buffer_size);
+    for (size_t i = 0; i < array_size(run_lengths); ++i) {
+        fill_runs(buffer, buffer_size, run_lengths[i], " \n\t  \r", 'x');
+        bench_one("space", scan_space, buffer, buffer_size, run_lengths[i]);
+    }
+    for (size_t i = 0; i < array_size(run_lengths); ++i) {
+        fill_runs(buffer, buffer_size, run_lengths[i], ident_alphabet, ' ');
+        bench_one("ident", scan_ident, buffer, buffer_size, run_lengths[i]);
+    }
+    my_free(buffer);
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void run_scan_bench(size_t buffer_size);
@@ -1,9 +1,7 @@
 #include "ast.h"
 
-void* ast_alloc_impl(AstContext* context, size_t bytes) {
-    void* memory = my_malloc(bytes);
-    vector_push_back(context, &memory);
-    return memory;
+void* ast_alloc_impl(AstContext* context, size_t bytes, size_t alignment) {
+    return arena_alloc(&context->arena, bytes, alignment);
 }
 
 static init_inlined_types(InlinedTypes* inlined) {
@@ -19,31 +17,105 @@ static init_inlined_types(InlinedTypes* inlined) {
     inlined->type_u64.is_unsigned  = true;
 }
 
-void ast_context_create(AstContext* ast, const char* original_text) {
-    ast->original_text = original_text;
-    ast->memory        = create_vector_AstKindPtr();
+Symbol ast_intern(AstContext* context, const char* string, size_t size) {
+    return intern(&context->interner, string, size);
+}
+
+const char* ast_symbol_string(const AstContext* context, Symbol symbol) {
+    return interner_string(&context->interner, symbol);
+}
+
+enum { TYPE_TABLE_INITIAL_CAPACITY = 16 };
+
+static PrimitiveType** allocate_type_slots(size_t capacity) {
+    PrimitiveType** slots = my_malloc(capacity * sizeof(PrimitiveType*));
+    memset(slots, 0, capacity * sizeof(PrimitiveType*));
+    return slots;
+}
+
+static uint32 hash_primitive(PrimitiveKind kind, uint16 integer_size, bool is_unsigned) {
+    uint32 key = (uint32) kind | (uint32) integer_size << 8 | (uint32) is_unsigned << 24;
+    return key * 2654435761u;
+}
+
+static PrimitiveType** find_type_slot(
+      const TypeTable* table, PrimitiveKind kind, uint16 integer_size, bool is_unsigned) {
+    size_t mask = table->capacity - 1;
+    for (size_t i = hash_primitive(kind, integer_size, is_unsigned) & mask;; i = (i + 1) & mask) {
+        PrimitiveType* type = table->slots[i];
+        if (type == NULL ||
+            (type->kind == kind && type->integer_size == integer_size && type->is_unsigned == is_unsigned)) {
+            return table->slots + i;
+        }
+    }
+}
+
+static void insert_type(TypeTable* table, PrimitiveType* type) {
+    if ((table->size + 1) * 2 > table->capacity) {
+        PrimitiveType** old_slots = table->slots;
+        size_t old_capacity       = table->capacity;
+
+        table->capacity *= 2;
+        table->slots = allocate_type_slots(table->capacity);
+        for (size_t i = 0; i < old_capacity; ++i) {
+            PrimitiveType* old = old_slots[i];
+            if (old) {
+                *find_type_slot(table, old->kind, old->integer_size, old->is_unsigned) = old;
+            }
+        }
+        my_free(old_slots);
+    }
+
+    *find_type_slot(table, type->kind, type->integer_size, type->is_unsigned) = type;
+    table->size++;
+}
+
+Type* ast_primitive_type(AstContext* context, PrimitiveKind kind, uint16 integer_size, bool is_unsigned) {
+    PrimitiveType** slot = find_type_slot(&context->types, kind, integer_size, is_unsigned);
+    if (*slot) {
+        return (Type*) *slot;
+    }
+
+    PrimitiveType* type = ast_alloc_in(context, PrimitiveType);
+    type->base.kind     = TYPE_PRIMITIVE;
+    type->kind          = kind;
+    type->integer_size  = integer_size;
+    type->is_unsigned   = is_unsigned;
+    insert_type(&context->types, type);
+    return (Type*) type;
+}
+
+void ast_context_create(AstContext* ast) {
+    ast->path = NULL;
+    arena_create(&ast->arena, AST_ARENA_CHUNK_SIZE);
+    interner_create(&ast->interner);
 
     init_inlined_types(&ast->inlined_types);
 
+    ast->types.capacity = TYPE_TABLE_INITIAL_CAPACITY;
+    ast->types.slots    = allocate_type_slots(ast->types.capacity);
+    ast->types.size     = 0;
+    insert_type(&ast->types, &ast->inlined_types.type_void);
+    insert_type(&ast->types, &ast->inlined_types.type_bool);
+    insert_type(&ast->types, &ast->inlined_types.type_u64);
+
     ast->type_void = (Type*) &ast->inlined_types.type_void;
     ast->type_bool = (Type*) &ast->inlined_types.type_bool;
     ast->type_u64  = (Type*) &ast->inlined_types.type_u64;
 }
 
-bool types_equal(const Type* l, const Type* r) {
-    if (l->kind != r->kind) {
-        return false;
-    }
-    switch (l->kind) {
-    case TYPE_PRIMITIVE: {
-        const PrimitiveType* left  = (const PrimitiveType*) l;
-        const PrimitiveType* right = (const PrimitiveType*) r;
-        return left->kind == right->kind && left->integer_size == right->integer_size &&
-               left->is_unsigned == right->is_unsigned;
-    }
-    }
+void ast_context_delete(AstContext* ast) {
+    arena_delete(&ast->arena);
+    interner_delete(&ast->interner);
+    my_free(ast->types.slots);
+    ast->types.slots = NULL;
+    ast->items      = NULL;
+    ast->items_size = 0;
+}
 
-    abort();
+// Types come from the type table, so there's only ever one instance of each.
+bool types_equal(const Type* l, const Type* r) {
+    return l == r;
 }
 
 bool type_is_void(const Type* t) {
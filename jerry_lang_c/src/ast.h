@@ -1,8 +1,11 @@
 #pragma once
 
 #include "lexer.h"
+#include "interner.h"
+#include "writer.h"
 
 typedef struct Expr Expr;
+typedef struct AstContext AstContext;
 
 typedef struct {
     int xxx;
@@ -52,9 +55,12 @@ typedef struct VariableAssignment {
 
     Token token_name;
 
-    const char* name;
-    size_t name_size;
+    Symbol name;
     Expr* init;
+    // The assignment that declared the variable; points to itself when `is_decl`.
+    struct VariableAssignment* declaration;
+    // Dense index of the variable among its function's locals, assigned during type fixing.
+    uint32 slot;
     bool is_decl : 1;
 } VariableAssignment;
 
@@ -77,6 +83,7 @@ typedef struct VariableReferenceExpr {
     Expr expr;
 
     Token token_name;
+    Symbol name;
     VariableAssignment* declaration;
 } VariableReferenceExpr;
 
@@ -158,27 +165,46 @@ typedef struct FunctionItem {
     Token token_function_name;
     Token token_return_type;
 
-    const char* name;
-    size_t name_size;
+    // Interned in `unit` until the program is linked, in the program's context after that.
+    Symbol name;
+    // Only meaningful when `token_return_type` is a real token.
+    Symbol return_type_name;
+    // The context the function was parsed into; every name in its body is interned there.
+    const AstContext* unit;
     FunctionArgument* arguments;
     size_t arguments_size;
     Block* block;
     Type* return_type;
+    uint32 locals_size;
+    // Hash of the function's tokens, from `fn` to the closing brace. Whitespace doesn't change it.
+    uint64 content_hash;
 } FunctionItem;
 
-VECTOR_OF(AstKind*, AstKindPtr);
-
 typedef struct InlinedTypes {
     PrimitiveType type_void;
     PrimitiveType type_bool;
     PrimitiveType type_u64;
 } InlinedTypes;
 
-typedef struct {
-    VectorAstKindPtr memory;
-    const char* original_text;
+// Hands out one PrimitiveType per distinct kind, size and signedness, so equal types are the same pointer.
+typedef struct TypeTable {
+    // Open addressing; NULL marks an empty slot.
+    PrimitiveType** slots;
+    size_t capacity;
+    size_t size;
+} TypeTable;
+
+enum { AST_ARENA_CHUNK_SIZE = 64 * 1024 };
+
+struct AstContext {
+    // The source file, for error messages; NULL when the text didn't come from a file.
+    const char* path;
+
+    Arena arena;
+    Interner interner;
 
     InlinedTypes inlined_types;
+    TypeTable types;
 
     Type* type_void;
     Type* type_bool;
@@ -186,11 +212,25 @@ typedef struct {
 
     Item** items;
     size_t items_size;
-} AstContext;
+};
+
+void* ast_alloc_impl(AstContext* context, size_t bytes, size_t alignment);
+
+#define ast_alloc_in(context, type) (type*) ast_alloc_impl(context, sizeof(type), align_of(type))
+
+#define ast_alloc_array_in(context, type, size) (type*) ast_alloc_impl(context, sizeof(type) * (size), align_of(type))
+
+Symbol ast_intern(AstContext* context, const char* string, size_t size);
+const char* ast_symbol_string(const AstContext* context, Symbol symbol);
+
+// Returns the canonical type, creating it on first use.
+Type* ast_primitive_type(AstContext* context, PrimitiveKind kind, uint16 integer_size, bool is_unsigned);
 
-void* ast_alloc_impl(AstContext* context, size_t bytes);
+void ast_context_create(AstContext* ast);
+void ast_context_delete(AstContext* ast);
 
-void ast_context_create(AstContext* ast, const char* original_text);
+// One node per line, children indented under their parent, every expression with its type. For --dump-ast.
+void ast_dump(const AstContext* ast, Writer* writer);
 
 bool types_equal(const Type* l, const Type* r);
 bool type_is_void(const Type* t);
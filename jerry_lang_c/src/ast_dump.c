@@ -0,0 +1,157 @@
+#include "ast.h"
+
+typedef struct AstDumper {
+    const AstContext* ast;
+    Writer* writer;
+    uint32 depth;
+} AstDumper;
+
+static const char* const binary_names[] = {
+    [BINARY_MINUS] = "-",
+    [BINARY_PLUS] = "+",
+    [BINARY_MUL] = "*",
+    [BINARY_DIV] = "/",
+    [BINARY_EQ] = "==",
+    [BINARY_NOT_EQ] = "!=",
+};
+
+static const char* const unary_names[] = {
+    [UNARY_MINUS] = "-",
+    [UNARY_PLUS] = "+",
+    [UNARY_ADDRESS_OF] = "&",
+};
+
+static void dump_expr(AstDumper* dumper, const Expr* expr);
+
+static void dump_indent(AstDumper* dumper) {
+    for (uint32 i = 0; i < dumper->depth; ++i) {
+        writer_write(dumper->writer, "  ", 2);
+    }
+}
+
+static void dump_symbol(AstDumper* dumper, Symbol symbol) {
+    const Interner* interner = &dumper->ast->interner;
+    writer_write(dumper->writer, interner_string(interner, symbol), interner_string_size(interner, symbol));
+}
+
+static void dump_primitive(AstDumper* dumper, const PrimitiveType* type) {
+    switch (type->kind) {
+    case PRIMITIVE_NUMBER:
+        writer_char(dumper->writer, type->is_unsigned ? 'u' : 's');
+        writer_uint(dumper->writer, type->integer_size);
+        break;
+    case PRIMITIVE_BOOL:
+        writer_string(dumper->writer, "bool");
+        break;
+    case PRIMITIVE_VOID:
+        writer_string(dumper->writer, "void");
+        break;
+    }
+}
+
+static void dump_type(AstDumper* dumper, const Type* type) {
+    ITERATE_TYPES(ITERATE_DEFAULT_RETURN_VOID, type, dump, dumper);
+}
+
+// " : <type>" and the end of the line.
+static void dump_type_suffix(AstDumper* dumper, const Type* type) {
+    writer_write(dumper->writer, " : ", 3);
+    if (type) {
+        dump_type(dumper, type);
+    } else {
+        writer_char(dumper->writer, '?');
+    }
+    writer_char(dumper->writer, '\n');
+}
+
+static void dump_child(AstDumper* dumper, const Expr* expr) {
+    dumper->depth++;
+    dump_expr(dumper, expr);
+    dumper->depth--;
+}
+
+static void dump_int_lit(AstDumper* dumper, const IntLitExpr* integer) {
+    writer_string(dumper->writer, "int ");
+    writer_uint(dumper->writer, integer->number);
+    dump_type_suffix(dumper, integer->expr.type);
+}
+
+static void dump_bool_lit(AstDumper* dumper, const BoolLitExpr* boolean) {
+    writer_string(dumper->writer, boolean->value ? "bool true" : "bool false");
+    dump_type_suffix(dumper, boolean->expr.type);
+}
+
+static void dump_var_ref(AstDumper* dumper, const VariableReferenceExpr* var) {
+    writer_string(dumper->writer, "var ");
+    dump_symbol(dumper, var->name);
+    dump_type_suffix(dumper, var->expr.type);
+}
+
+static void dump_paren(AstDumper* dumper, const ParenExpr* paren) {
+    writer_string(dumper->writer, "paren");
+    dump_type_suffix(dumper, paren->expr.type);
+    dump_child(dumper, paren->subexpression);
+}
+
+static void dump_unary(AstDumper* dumper, const UnaryExpr* unary) {
+    writer_string(dumper->writer, "unary ");
+    writer_string(dumper->writer, unary_names[unary->kind]);
+    dump_type_suffix(dumper, unary->base.type);
+    dump_child(dumper, unary->subexpression);
+}
+
+static void dump_binary(AstDumper* dumper, const BinaryExpr* binary) {
+    writer_string(dumper->writer, "binary ");
+    writer_string(dumper->writer, binary_names[binary->kind]);
+    dump_type_suffix(dumper, binary->expr.type);
+    dump_child(dumper, binary->left);
+    dump_child(dumper, binary->right);
+}
+
+static void dump_expr(AstDumper* dumper, const Expr* expr) {
+    dump_indent(dumper);
+    ITERATE_EXPRS(ITERATE_DEFAULT_RETURN_VOID, expr, dump, dumper);
+}
+
+static void dump_var_assign(AstDumper* dumper, const VariableAssignment* assign) {
+    writer_string(dumper->writer, assign->is_decl ? "let " : "assign ");
+    dump_symbol(dumper, assign->name);
+    dump_type_suffix(dumper, assign->init->type);
+    dump_child(dumper, assign->init);
+}
+
+static void dump_return(AstDumper* dumper, const ReturnStmt* return_stmt) {
+    writer_string(dumper->writer, "return\n");
+    if (return_stmt->subexpr) {
+        dump_child(dumper, return_stmt->subexpr);
+    }
+}
+
+static void dump_stmt(AstDumper* dumper, const Stmt* stmt) {
+    dump_indent(dumper);
+    ITERATE_STMTS(ITERATE_DEFAULT_RETURN_VOID, stmt, dump, dumper);
+}
+
+static void dump_function(AstDumper* dumper, const FunctionItem* function) {
+    writer_string(dumper->writer, "fn ");
+    dump_symbol(dumper, function->name);
+    dump_type_suffix(dumper, function->return_type);
+
+    dumper->depth++;
+    const Block* block = function->block;
+    for (size_t i = 0; i < block->stmts_size; ++i) {
+        dump_stmt(dumper, block->stmts[i]);
+    }
+    dumper->depth--;
+}
+
+static void dump_item(AstDumper* dumper, const Item* item) {
+    ITERATE_ITEMS(ITERATE_DEFAULT_RETURN_VOID, item, dump, dumper);
+}
+
+void ast_dump(const AstContext* ast, Writer* writer) {
+    AstDumper dumper = { .ast = ast, .writer = writer, .depth = 0 };
+    for (size_t i = 0; i < ast->items_size; ++i) {
+        dump_item(&dumper, ast->items[i]);
+    }
+}
@@ -0,0 +1,152 @@
+// For dladdr in glibc.
+#define _GNU_SOURCE
+#include "cache.h"
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#    include <direct.h>
+#    include <process.h>
+#else
+#    include <dlfcn.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    ifdef __APPLE__
+#        include <mach-o/dyld.h>
+#    endif
+#endif
+
+enum {
+    CACHE_PATH_SIZE      = 4096,
+    EXECUTABLE_READ_SIZE = 64 * 1024,
+};
+
+void file_cache_open(FileCache* cache, const char* directory) {
+#ifdef _WIN32
+    _mkdir(directory);
+#else
+    mkdir(directory, 0777);
+#endif
+    cache->directory = directory;
+}
+
+static void entry_path(const FileCache* cache, uint64 key, char* path) {
+    int written = snprintf(path, CACHE_PATH_SIZE, "%s/%016llx", cache->directory, (unsigned long long) key);
+    bail_out_if(written > 0 && written < CACHE_PATH_SIZE, "cache path too long");
+}
+
+void* file_cache_read(const FileCache* cache, uint64 key, size_t* size) {
+    char path[CACHE_PATH_SIZE];
+    entry_path(cache, key, path);
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void* data = NULL;
+    if (file_size > 0) {
+        data = my_malloc(file_size);
+        if (fread(data, 1, file_size, file) != (size_t) file_size) {
+            my_free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+
+    *size = file_size;
+    return data;
+}
+
+void file_cache_write(const FileCache* cache, uint64 key, const void* data, size_t size) {
+    char path[CACHE_PATH_SIZE];
+    entry_path(cache, key, path);
+
+    // Unique among concurrent writers: the process id tells processes apart and `data` threads within one.
+    char temp_path[CACHE_PATH_SIZE];
+#ifdef _WIN32
+    int process = _getpid();
+#else
+    int process = getpid();
+#endif
+    int written = snprintf(temp_path, CACHE_PATH_SIZE, "%s.%d.%p.tmp", path, process, data);
+    bail_out_if(written > 0 && written < CACHE_PATH_SIZE, "cache path too long");
+
+    FILE* file = fopen(temp_path, "wb");
+    if (file == NULL) {
+        return;
+    }
+    bool complete = fwrite(data, 1, size, file) == size;
+    complete      = fclose(file) == 0 && complete;
+
+    // Renaming over an existing entry fails on Windows; whoever got there first wrote the same bytes.
+    if (!complete || rename(temp_path, path) != 0) {
+        remove(temp_path);
+    }
+}
+
+static void executable_path(char* path) {
+#ifdef _WIN32
+    DWORD written = GetModuleFileNameA(NULL, path, CACHE_PATH_SIZE);
+    bail_out_if(written > 0 && written < CACHE_PATH_SIZE, "can't find the compiler executable");
+#elif defined(__APPLE__)
+    uint32_t size = CACHE_PATH_SIZE;
+    bail_out_if(_NSGetExecutablePath(path, &size) == 0, "can't find the compiler executable");
+#else
+    strcpy(path, "/proc/self/exe");
+#endif
+}
+
+uint64 hash_compiler_executable(uint64 hash) {
+    char path[CACHE_PATH_SIZE];
+    executable_path(path);
+
+    FILE* file = fopen(path, "rb");
+    bail_out_if(file, "can't read the compiler executable");
+    uint8* buffer = my_malloc(EXECUTABLE_READ_SIZE);
+    size_t read;
+    while ((read = fread(buffer, 1, EXECUTABLE_READ_SIZE, file)) > 0) {
+        hash = hash64_update(hash, buffer, read);
+    }
+    bail_out_if(!ferror(file), "can't read the compiler executable");
+    my_free(buffer);
+    fclose(file);
+    return hash;
+}
+
+uint64 hash_shared_library(uint64 hash, const void* symbol, const char* windows_name) {
+#ifdef _WIN32
+    (void) symbol;
+    HMODULE module = GetModuleHandleA(windows_name);
+    if (module == NULL) {
+        return hash;
+    }
+    char path[CACHE_PATH_SIZE];
+    DWORD written = GetModuleFileNameA(module, path, CACHE_PATH_SIZE);
+    bail_out_if(written > 0 && written < CACHE_PATH_SIZE, "can't find a shared library");
+
+    WIN32_FILE_ATTRIBUTE_DATA status;
+    bail_out_if(GetFileAttributesExA(path, GetFileExInfoStandard, &status), "can't stat a shared library");
+    hash = hash64_update(hash, path, strlen(path) + 1);
+    hash = hash64_update(hash, &status.nFileSizeHigh, sizeof(status.nFileSizeHigh));
+    hash = hash64_update(hash, &status.nFileSizeLow, sizeof(status.nFileSizeLow));
+    hash = hash64_update(hash, &status.ftLastWriteTime, sizeof(status.ftLastWriteTime));
+#else
+    (void) windows_name;
+    Dl_info info;
+    if (dladdr(symbol, &info) == 0 || info.dli_fname == NULL) {
+        return hash;
+    }
+    struct stat status;
+    bail_out_if(stat(info.dli_fname, &status) == 0, "can't stat a shared library");
+    // Package managers replace a library with a new file, so the inode changes even if the time is kept.
+    uint64 identity[] = { (uint64) status.st_dev, (uint64) status.st_ino, (uint64) status.st_size,
+                          (uint64) status.st_mtime };
+    hash = hash64_update(hash, info.dli_fname, strlen(info.dli_fname) + 1);
+    hash = hash64_update(hash, identity, sizeof(identity));
+#endif
+    return hash;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common.h"
+
+// Blobs in a directory, one file per 64-bit key. Entries are written to a temporary file and renamed into place,
+// so threads or processes sharing the directory never see a half-written entry.
+typedef struct FileCache {
+    // NULL when caching is off.
+    const char* directory;
+} FileCache;
+
+// Creates `directory` if it doesn't exist yet.
+void file_cache_open(FileCache* cache, const char* directory);
+
+// Returns NULL on a miss. The caller frees the result.
+void* file_cache_read(const FileCache* cache, uint64 key, size_t* size);
+// Failing to write is not an error; the entry is just missing next time.
+void file_cache_write(const FileCache* cache, uint64 key, const void* data, size_t size);
+
+// Adds the contents of the running compiler's executable to `hash`. Any rebuild of the compiler, whichever of its
+// source files changed, then gets keys of its own.
+uint64 hash_compiler_executable(uint64 hash);
+
+// Adds the path, size and modification time of the shared library `symbol` comes from to `hash`, so replacing
+// the library changes it. On Windows a function's address points into the executable's import thunks, so the
+// library is found by `windows_name` instead; when it isn't loaded it was linked in statically, and
+// hash_compiler_executable covers it.
+uint64 hash_shared_library(uint64 hash, const void* symbol, const char* windows_name);
@@ -1,18 +1,40 @@
 ﻿#include <llvm-c/Core.h>
 #include <llvm-c/Analysis.h>
+#include <llvm-c/BitReader.h>
+#include <llvm-c/BitWriter.h>
+#include <llvm-c/Linker.h>
+#include <llvm-c/Support.h>
+#include <llvm-c/Target.h>
+#include <llvm-c/TargetMachine.h>
+#include <llvm-c/Transforms/PassManagerBuilder.h>
+#include "cache.h"
 #include "codegen.h"
+#include "jit.h"
+#include "thread.h"
 
-typedef struct VariableMapping {
-    const VariableAssignment* variable;
-    LLVMValueRef l_variable;
-} VariableMapping;
-
-VECTOR_OF(VariableMapping, VariableMapping);
-
+// One module being built. With more than one job every worker has its own, in its own LLVM context.
 typedef struct CodeGen {
     const AstContext* ast;
-
-    VectorVariableMapping variable_mapping;
+    // Where the names in the body of the function being built are interned.
+    const AstContext* unit;
+    CodeGenOptions options;
+
+    // Only set on the codegen returned by `codegen_create`; workers borrow the strings.
+    LLVMTargetMachineRef machine;
+    char* triple;
+    char* data_layout;
+    // Owns `context` when running under the JIT.
+    JitContext* jit_context;
+
+    FileCache cache;
+    // Hash of everything besides a function's own tokens that goes into its cache key.
+    uint64 cache_salt;
+
+    // Current value of each of the current function's locals, indexed by `VariableAssignment::slot`. Locals live
+    // in SSA values rather than allocas. The language has no branches yet, so a function is a single block and this
+    // is all SSA construction needs; once it does, this becomes a map per block, with phis where blocks join.
+    LLVMValueRef* locals;
+    size_t locals_capacity;
 
     LLVMContextRef context;
     LLVMModuleRef module;
@@ -25,12 +47,22 @@ typedef struct CodeGen {
     LLVMValueRef value_false;
 } CodeGen;
 
-CodeGen* codegen_create(const AstContext* ast_context) {
-    CodeGen* codegen          = my_malloc(sizeof(CodeGen));
-    codegen->ast              = ast_context;
-    codegen->variable_mapping = create_vector_VariableMapping();
-
-    codegen->context = LLVMContextCreate();
+// Creates a new LLVM context unless `context` is given.
+static void init_codegen(
+      CodeGen* codegen, const AstContext* ast_context, const CodeGenOptions* options, LLVMContextRef context) {
+    codegen->ast             = ast_context;
+    codegen->unit            = ast_context;
+    codegen->options         = *options;
+    codegen->machine         = NULL;
+    codegen->triple          = NULL;
+    codegen->data_layout     = NULL;
+    codegen->locals          = NULL;
+    codegen->locals_capacity = 0;
+
+    codegen->jit_context     = NULL;
+    codegen->cache.directory = NULL;
+    codegen->cache_salt      = 0;
+    codegen->context         = context ? context : LLVMContextCreate();
     bail_out_if(codegen->context, "can't");
 
     codegen->module  = LLVMModuleCreateWithNameInContext("mouse", codegen->context);
@@ -41,10 +73,110 @@ CodeGen* codegen_create(const AstContext* ast_context) {
 
     codegen->value_true  = LLVMConstInt(codegen->type_bool, 1, false);
     codegen->value_false = LLVMConstInt(codegen->type_bool, 0, false);
+}
+
+static void deinit_codegen(CodeGen* codegen) {
+    my_free(codegen->locals);
+    LLVMDisposeBuilder(codegen->builder);
+    if (codegen->module) {
+        LLVMDisposeModule(codegen->module);
+    }
+    if (codegen->jit_context) {
+        jit_context_delete(codegen->jit_context);
+    } else {
+        LLVMContextDispose(codegen->context);
+    }
+}
+
+static void set_target(CodeGen* codegen, const char* triple, const char* data_layout) {
+    LLVMSetTarget(codegen->module, triple);
+    LLVMSetDataLayout(codegen->module, data_layout);
+}
 
+static void bail_out_on_llvm_error(bool failed, char* error, const char* message) {
+    if (failed) {
+        fprintf(stderr, "%s\n", error ? error : "");
+        bail_out(message);
+    }
+    LLVMDisposeMessage(error);
+}
+
+static void create_target_machine(CodeGen* codegen) {
+    LLVMInitializeNativeTarget();
+    LLVMInitializeNativeAsmPrinter();
+
+    codegen->triple = LLVMGetDefaultTargetTriple();
+
+    LLVMTargetRef target;
+    char* error = NULL;
+    bail_out_on_llvm_error(
+          LLVMGetTargetFromTriple(codegen->triple, &target, &error) != 0,
+          error,
+          "no target for this triple");
+
+    // "generic" keeps the object the same whatever machine it's built on.
+    codegen->machine = LLVMCreateTargetMachine(
+          target,
+          codegen->triple,
+          "generic",
+          "",
+          (LLVMCodeGenOptLevel) codegen->options.opt_level,
+          LLVMRelocPIC,
+          LLVMCodeModelDefault);
+
+    LLVMTargetDataRef data_layout = LLVMCreateTargetDataLayout(codegen->machine);
+    codegen->data_layout          = LLVMCopyStringRepOfTargetData(data_layout);
+    LLVMDisposeTargetData(data_layout);
+}
+
+// Everything besides the function's own tokens that changes the IR built for it.
+static uint64 compute_cache_salt(const CodeGen* codegen) {
+    // The executable covers a rebuild of any part of the compiler, so a new build never picks up entries an older
+    // one wrote. LLVM can be a shared library that gets upgraded under an unchanged executable, and its version
+    // macros are baked into the executable, so the loaded library file goes in separately.
+    uint64 salt = HASH64_SEED;
+    salt        = hash_compiler_executable(salt);
+    salt        = hash_shared_library(salt, (const void*) (uintptr_t) LLVMContextCreate, "LLVM-C.dll");
+    salt        = hash64_update(salt, &codegen->options.opt_level, sizeof(codegen->options.opt_level));
+    salt        = hash64_update(salt, codegen->triple, strlen(codegen->triple) + 1);
+    salt        = hash64_update(salt, codegen->data_layout, strlen(codegen->data_layout) + 1);
+    return salt;
+}
+
+CodeGen* codegen_create(const AstContext* ast_context, const CodeGenOptions* options) {
+    bail_out_if(options->opt_level <= 3, "optimization level must be between 0 and 3");
+    if (options->time_passes) {
+        // LLVM prints the table, one line per pass, to stderr in codegen_shutdown.
+        const char* args[] = { "jerry_lang_c", "-time-passes" };
+        LLVMParseCommandLineOptions(array_size(args), args, NULL);
+    }
+
+    CodeGen* codegen = my_malloc(sizeof(CodeGen));
+    if (options->jit) {
+        // The JIT takes modules along with the context they live in, so the module is built in one it can share.
+        JitContext* jit_context = jit_context_create();
+        init_codegen(codegen, ast_context, options, jit_context_llvm(jit_context));
+        codegen->jit_context = jit_context;
+    } else {
+        init_codegen(codegen, ast_context, options, NULL);
+    }
+    create_target_machine(codegen);
+    set_target(codegen, codegen->triple, codegen->data_layout);
+    if (options->cache_directory) {
+        file_cache_open(&codegen->cache, options->cache_directory);
+        codegen->cache_salt = compute_cache_salt(codegen);
+    }
     return codegen;
 }
 
+void codegen_delete(CodeGen* codegen) {
+    deinit_codegen(codegen);
+    LLVMDisposeTargetMachine(codegen->machine);
+    LLVMDisposeMessage(codegen->triple);
+    LLVMDisposeMessage(codegen->data_layout);
+    my_free(codegen);
+}
+
 static LLVMValueRef codegen_expr(CodeGen* codegen, const Expr* expr);
 
 static LLVMTypeRef translate_primitive(CodeGen* codegen, const PrimitiveType* type) {
@@ -53,6 +185,8 @@ static LLVMTypeRef translate_primitive(CodeGen* codegen, const PrimitiveType* ty
         return LLVMIntTypeInContext(codegen->context, type->integer_size);
     case PRIMITIVE_BOOL:
         return codegen->type_bool;
+    case PRIMITIVE_VOID:
+        return codegen->type_void;
     }
     abort();
 }
@@ -75,13 +209,7 @@ static LLVMValueRef codegen_paren(CodeGen* codegen, const ParenExpr* expr) {
 }
 
 static LLVMValueRef codegen_var_ref(CodeGen* codegen, const VariableReferenceExpr* expr) {
-    for (size_t i = 0; i < codegen->variable_mapping.size; ++i) {
-        VariableMapping current = codegen->variable_mapping.ptr[i];
-        if (current.variable == expr->declaration) {
-            return LLVMBuildLoad(codegen->builder, current.l_variable, "");
-        }
-    }
-    bail_out("no");
+    return codegen->locals[expr->declaration->slot];
 }
 
 static LLVMValueRef codegen_unary(CodeGen* codegen, const UnaryExpr* expr) {
@@ -117,26 +245,15 @@ static LLVMValueRef codegen_expr(CodeGen* codegen, const Expr* expr) {
 }
 
 static void codegen_var_assign(CodeGen* codegen, const VariableAssignment* var) {
-    make_string_stack(name, MAX_FUNCTION_SIZE, var->name, var->name_size);
-
-    LLVMTypeRef type   = translate_type(codegen, var->init->type);
-    LLVMValueRef alloc = NULL;
-    if (var->is_decl) {
-        alloc                   = LLVMBuildAlloca(codegen->builder, type, name);
-        VariableMapping mapping = { .variable = var, .l_variable = alloc };
-        vector_push_back(&codegen->variable_mapping, &mapping);
-    } else {
-        for (size_t i = 0; i < codegen->variable_mapping.size; ++i) {
-            VariableMapping current = codegen->variable_mapping.ptr[i];
-            if (current.variable == var) {
-                alloc = current.l_variable;
-            }
-        }
-        bail_out_if(alloc, "no");
-    }
-
     LLVMValueRef value = codegen_expr(codegen, var->init);
-    LLVMBuildStore(codegen->builder, value, alloc);
+
+    // Keeps the IR readable: the instruction computing a variable is named after the first variable it lands in.
+    size_t name_size;
+    if (LLVMIsAInstruction(value) && (LLVMGetValueName2(value, &name_size), name_size == 0)) {
+        const char* name = ast_symbol_string(codegen->unit, var->name);
+        LLVMSetValueName2(value, name, strlen(name));
+    }
+    codegen->locals[var->slot] = value;
 }
 
 static void codegen_return(CodeGen* codegen, const ReturnStmt* return_stmt) {
@@ -159,7 +276,8 @@ static void codegen_block(CodeGen* codegen, const Block* block) {
 }
 
 static void codegen_function(CodeGen* codegen, const FunctionItem* function) {
-    make_string_stack(name, MAX_FUNCTION_SIZE, function->name, function->name_size);
+    const char* name = ast_symbol_string(codegen->ast, function->name);
+    codegen->unit    = function->unit;
 
     LLVMTypeRef return_type   = translate_type(codegen, function->return_type);
     LLVMTypeRef function_type = LLVMFunctionType(return_type, NULL, 0, false);
@@ -168,9 +286,15 @@ static void codegen_function(CodeGen* codegen, const FunctionItem* function) {
     LLVMBasicBlockRef entry = LLVMAppendBasicBlockInContext(codegen->context, l_function, name);
     LLVMPositionBuilderAtEnd(codegen->builder, entry);
 
+    if (function->locals_size > codegen->locals_capacity) {
+        my_free(codegen->locals);
+        codegen->locals_capacity = function->locals_size;
+        codegen->locals          = my_malloc(codegen->locals_capacity * sizeof(LLVMValueRef));
+    }
     codegen_block(codegen, function->block);
 
-    if (type_is_void(function->return_type)) {
+    bool has_return = LLVMGetBasicBlockTerminator(LLVMGetInsertBlock(codegen->builder)) != NULL;
+    if (type_is_void(function->return_type) && !has_return) {
         LLVMBuildRetVoid(codegen->builder);
     }
 }
@@ -179,15 +303,339 @@ static void codegen_item(CodeGen* codegen, const Item* item) {
     ITERATE_ITEMS(ITERATE_DEFAULT_RETURN_VOID, item, codegen, codegen);
 }
 
-void codegen_run(CodeGen* codegen) {
-    for (size_t i = 0; i < codegen->ast->items_size; ++i) {
+// The legacy pass manager and its builder exist up to LLVM 16; LLVM 17 removed them. Moving to a newer LLVM means
+// running the pipelines through the new pass manager instead, with LLVMRunPasses and a "default<On>" pipeline.
+static LLVMPassManagerBuilderRef create_pass_builder(const CodeGen* codegen) {
+    LLVMPassManagerBuilderRef builder = LLVMPassManagerBuilderCreate();
+    LLVMPassManagerBuilderSetOptLevel(builder, codegen->options.opt_level);
+    if (codegen->options.opt_level > 1) {
+        LLVMPassManagerBuilderUseInlinerWithThreshold(builder, codegen->options.opt_level == 3 ? 275 : 225);
+    }
+    return builder;
+}
+
+// The per-function simplification passes. They only look at one function at a time, so workers run them on
+// their own module before it's linked.
+static void run_function_passes(CodeGen* codegen) {
+    if (codegen->options.opt_level == 0) {
+        return;
+    }
+    LLVMPassManagerBuilderRef builder = create_pass_builder(codegen);
+    LLVMPassManagerRef passes         = LLVMCreateFunctionPassManagerForModule(codegen->module);
+    LLVMPassManagerBuilderPopulateFunctionPassManager(builder, passes);
+
+    LLVMInitializeFunctionPassManager(passes);
+    LLVMValueRef function = LLVMGetFirstFunction(codegen->module);
+    for (; function; function = LLVMGetNextFunction(function)) {
+        LLVMRunFunctionPassManager(passes, function);
+    }
+    LLVMFinalizeFunctionPassManager(passes);
+
+    LLVMDisposePassManager(passes);
+    LLVMPassManagerBuilderDispose(builder);
+}
+
+static void run_module_passes(CodeGen* codegen) {
+    if (codegen->options.opt_level == 0) {
+        return;
+    }
+    LLVMPassManagerBuilderRef builder = create_pass_builder(codegen);
+    LLVMPassManagerRef passes         = LLVMCreatePassManager();
+    LLVMPassManagerBuilderPopulateModulePassManager(builder, passes);
+    LLVMRunPassManager(passes, codegen->module);
+
+    LLVMDisposePassManager(passes);
+    LLVMPassManagerBuilderDispose(builder);
+}
+
+// Builds `function` on its own in a new module, through the passes that only look at the function itself.
+static LLVMModuleRef build_function_module(CodeGen* codegen, const FunctionItem* function) {
+    LLVMModuleRef main_module = codegen->module;
+    codegen->module           = LLVMModuleCreateWithNameInContext("mouse", codegen->context);
+    LLVMSetTarget(codegen->module, LLVMGetTarget(main_module));
+    LLVMSetDataLayout(codegen->module, LLVMGetDataLayoutStr(main_module));
+
+    codegen_function(codegen, function);
+    LLVMVerifyModule(codegen->module, LLVMAbortProcessAction, NULL);
+    run_function_passes(codegen);
+
+    LLVMModuleRef module = codegen->module;
+    codegen->module      = main_module;
+    return module;
+}
+
+// Goes in front of the function's name and its bitcode in every entry. Keys are only 64-bit hashes, so an entry
+// is used only if it was written for the same salt, tokens and name; a collision or a stray file in the directory
+// is treated like a damaged entry.
+typedef struct CacheEntryHeader {
+    uint64 salt;
+    uint64 content_hash;
+    uint64 name_size;
+} CacheEntryHeader;
+
+// The bitcode starts 8-byte aligned, after the header and the name.
+static size_t cache_entry_bitcode_offset(size_t name_size) {
+    return (sizeof(CacheEntryHeader) + name_size + 7) & ~(size_t) 7;
+}
+
+static bool cache_entry_matches(const char* data, size_t size, const CacheEntryHeader* expected, const char* name) {
+    CacheEntryHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    return header.salt == expected->salt && header.content_hash == expected->content_hash &&
+           header.name_size == expected->name_size && cache_entry_bitcode_offset(header.name_size) <= size &&
+           memcmp(data + sizeof(header), name, header.name_size) == 0;
+}
+
+static LLVMModuleRef read_cached_module(
+      CodeGen* codegen, uint64 key, const CacheEntryHeader* expected, const char* name) {
+    size_t size;
+    char* data = file_cache_read(&codegen->cache, key, &size);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    // A damaged or foreign entry is rebuilt and overwritten.
+    LLVMModuleRef module = NULL;
+    if (cache_entry_matches(data, size, expected, name)) {
+        size_t offset = cache_entry_bitcode_offset(expected->name_size);
+        LLVMMemoryBufferRef buffer =
+              LLVMCreateMemoryBufferWithMemoryRange(data + offset, size - offset, "cache", false);
+        if (LLVMParseBitcodeInContext2(codegen->context, buffer, &module) != 0) {
+            module = NULL;
+        }
+        LLVMDisposeMemoryBuffer(buffer);
+    }
+    my_free(data);
+    return module;
+}
+
+static void write_cached_module(
+      CodeGen* codegen, uint64 key, const CacheEntryHeader* header, const char* name, LLVMModuleRef module) {
+    LLVMMemoryBufferRef bitcode = LLVMWriteBitcodeToMemoryBuffer(module);
+    size_t offset               = cache_entry_bitcode_offset(header->name_size);
+    size_t bitcode_size         = LLVMGetBufferSize(bitcode);
+
+    char* entry = my_malloc(offset + bitcode_size);
+    memset(entry, 0, offset);
+    memcpy(entry, header, sizeof(*header));
+    memcpy(entry + sizeof(*header), name, header->name_size);
+    memcpy(entry + offset, LLVMGetBufferStart(bitcode), bitcode_size);
+    file_cache_write(&codegen->cache, key, entry, offset + bitcode_size);
+
+    my_free(entry);
+    LLVMDisposeMemoryBuffer(bitcode);
+}
+
+// A function's IR only depends on its own tokens and the salt, so unchanged functions are read back instead of
+// being built again.
+static LLVMModuleRef codegen_cached_function(CodeGen* codegen, const FunctionItem* function) {
+    const char* name = ast_symbol_string(codegen->ast, function->name);
+    CacheEntryHeader header;
+    header.salt         = codegen->cache_salt;
+    header.content_hash = function->content_hash;
+    header.name_size    = strlen(name);
+    uint64 key          = hash64_update(codegen->cache_salt, &function->content_hash, sizeof(function->content_hash));
+
+    LLVMModuleRef module = read_cached_module(codegen, key, &header, name);
+    if (module == NULL) {
+        module = build_function_module(codegen, function);
+        write_cached_module(codegen, key, &header, name, module);
+    }
+    return module;
+}
+
+static LLVMModuleRef codegen_cached_item(CodeGen* codegen, const Item* item) {
+    ITERATE_ITEMS(ITERATE_DEFAULT_RETURN, item, codegen_cached, codegen);
+    abort();
+}
+
+// Every link walks all the types in the destination module, so linking the pieces one by one into the same module
+// is quadratic. Merging neighbours pairwise keeps it at n log n, and keeps the functions in item order.
+static void link_balanced(CodeGen* codegen, LLVMModuleRef* modules, size_t count) {
+    for (size_t width = 1; width < count; width *= 2) {
+        for (size_t i = 0; i + width < count; i += 2 * width) {
+            bail_out_if(LLVMLinkModules2(modules[i], modules[i + width]) == 0, "can't link modules");
+        }
+    }
+    if (count > 0) {
+        bail_out_if(LLVMLinkModules2(codegen->module, modules[0]) == 0, "can't link modules");
+    }
+}
+
+static void codegen_items(CodeGen* codegen, size_t begin, size_t end) {
+    if (codegen->cache.directory) {
+        LLVMModuleRef* modules = my_malloc((end - begin) * sizeof(LLVMModuleRef));
+        for (size_t i = begin; i < end; ++i) {
+            modules[i - begin] = codegen_cached_item(codegen, codegen->ast->items[i]);
+        }
+        link_balanced(codegen, modules, end - begin);
+        my_free(modules);
+        return;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
         codegen_item(codegen, codegen->ast->items[i]);
     }
+    LLVMVerifyModule(codegen->module, LLVMAbortProcessAction, NULL);
+    run_function_passes(codegen);
+}
 
-    printf("\n\n");
-    if (LLVMPrintModuleToFile(codegen->module, "llvm.ir", NULL) == 1) {
-        abort();
+typedef struct CodeGenWorker {
+    const CodeGen* parent;
+    size_t begin;
+    size_t end;
+    LLVMMemoryBufferRef bitcode;
+    Thread thread;
+} CodeGenWorker;
+
+// Builds a contiguous range of items in a private context. Modules can only be linked within one context, so
+// the result is handed back as bitcode.
+static void run_worker(void* argument) {
+    CodeGenWorker* worker = argument;
+
+    CodeGen codegen;
+    init_codegen(&codegen, worker->parent->ast, &worker->parent->options, NULL);
+    set_target(&codegen, worker->parent->triple, worker->parent->data_layout);
+    codegen.cache      = worker->parent->cache;
+    codegen.cache_salt = worker->parent->cache_salt;
+    codegen_items(&codegen, worker->begin, worker->end);
+    worker->bitcode = LLVMWriteBitcodeToMemoryBuffer(codegen.module);
+    deinit_codegen(&codegen);
+}
+
+// Every worker gets a contiguous range of items and the modules are linked back in item order, so the result
+// is the same for any number of jobs.
+static void codegen_parallel(CodeGen* codegen, size_t jobs) {
+    size_t items_size      = codegen->ast->items_size;
+    CodeGenWorker* workers = my_malloc(jobs * sizeof(CodeGenWorker));
+    for (size_t i = 0; i < jobs; ++i) {
+        CodeGenWorker* worker = workers + i;
+        worker->parent        = codegen;
+        worker->begin         = items_size * i / jobs;
+        worker->end           = items_size * (i + 1) / jobs;
+        worker->bitcode       = NULL;
+        thread_start(&worker->thread, run_worker, worker);
+    }
+
+    for (size_t i = 0; i < jobs; ++i) {
+        CodeGenWorker* worker = workers + i;
+        thread_join(&worker->thread);
+
+        LLVMModuleRef module;
+        bail_out_if(LLVMParseBitcodeInContext2(codegen->context, worker->bitcode, &module) == 0, "bad bitcode");
+        LLVMDisposeMemoryBuffer(worker->bitcode);
+        bail_out_if(LLVMLinkModules2(codegen->module, module) == 0, "can't link modules");
+    }
+    my_free(workers);
+}
+
+static const char* default_output_path(EmitKind emit) {
+    switch (emit) {
+    case EMIT_OBJECT:
+#ifdef _WIN32
+        return "out.obj";
+#else
+        return "out.o";
+#endif
+    case EMIT_BITCODE:
+        return "out.bc";
+    case EMIT_IR:
+        return "llvm.ir";
     }
+    abort();
+}
+
+static void emit_module(CodeGen* codegen) {
+    const char* path = codegen->options.output_path;
+    if (path == NULL) {
+        path = default_output_path(codegen->options.emit);
+    }
+
+    char* error = NULL;
+    switch (codegen->options.emit) {
+    case EMIT_OBJECT: {
+        bool failed =
+              LLVMTargetMachineEmitToFile(codegen->machine, codegen->module, (char*) path, LLVMObjectFile, &error);
+        bail_out_on_llvm_error(failed, error, "can't write object file");
+        break;
+    }
+    case EMIT_BITCODE:
+        bail_out_if(LLVMWriteBitcodeToFile(codegen->module, path) == 0, "can't write bitcode");
+        break;
+    case EMIT_IR:
+        bail_out_on_llvm_error(LLVMPrintModuleToFile(codegen->module, path, &error), error, "can't write ir");
+        break;
+    }
+}
+
+static const FunctionItem* find_main(const AstContext* ast) {
+    for (size_t i = 0; i < ast->items_size; ++i) {
+        const Item* item = ast->items[i];
+        if (item->kind == ITEM_FUNCTION) {
+            const FunctionItem* function = (const FunctionItem*) item;
+            if (function->block && strcmp(ast_symbol_string(ast, function->name), "main") == 0) {
+                return function;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Only the low `integer_size` bits of the return register are defined. They're widened the way the C ABI would
+// for an object file's main: signed types are sign extended, so an s8 -1 exits with -1 rather than 255.
+static int exit_code_from(const Type* return_type, uint64 value) {
+    if (type_is_void(return_type)) {
+        return 0;
+    }
+    const PrimitiveType* primitive = (const PrimitiveType*) return_type;
+    if (primitive->kind == PRIMITIVE_BOOL) {
+        return (int) (value & 1);
+    }
+    if (primitive->integer_size < 64) {
+        uint64 mask = ((uint64) 1 << primitive->integer_size) - 1;
+        uint64 sign = (uint64) 1 << (primitive->integer_size - 1);
+        value &= mask;
+        if (!primitive->is_unsigned && (value & sign)) {
+            value |= ~mask;
+        }
+    }
+    return (int) (int64_t) value;
+}
+
+static int run_jit(CodeGen* codegen) {
+    const FunctionItem* main_function = find_main(codegen->ast);
+    bail_out_if(main_function, "no main function to run");
+
+    uint64 result   = jit_run(codegen->jit_context, codegen->module, "main");
+    codegen->module = NULL;
+    return exit_code_from(main_function->return_type, result);
+}
+
+int codegen_run(CodeGen* codegen) {
+    TimeReport* report = codegen->options.time_report;
+    size_t jobs = codegen->options.jobs == 0 ? hardware_thread_count() : codegen->options.jobs;
+    jobs        = min(jobs, codegen->ast->items_size);
+    if (jobs > 1) {
+        codegen_parallel(codegen, jobs);
+    } else {
+        codegen_items(codegen, 0, codegen->ast->items_size);
+    }
+
+    time_report_phase(report, "module passes");
+    run_module_passes(codegen);
+
+    if (codegen->options.jit) {
+        time_report_phase(report, "jit");
+        return run_jit(codegen);
+    }
+    time_report_phase(report, "emit");
+    emit_module(codegen);
+    return 0;
+}
 
-    bool huh = LLVMVerifyModule(codegen->module, LLVMAbortProcessAction, NULL);
+void codegen_shutdown() {
+    LLVMShutdown();
 }
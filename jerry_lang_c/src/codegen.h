@@ -2,8 +2,44 @@
 
 #include "common.h"
 #include "ast.h"
+#include "time_report.h"
+
+typedef enum EmitKind {
+    EMIT_OBJECT,
+    EMIT_BITCODE,
+    // Textual IR, for debugging.
+    EMIT_IR,
+} EmitKind;
+
+typedef struct CodeGenOptions {
+    // Threads building IR; 0 uses one per hardware thread.
+    uint32 jobs;
+    // 0 to 3, as in -O0 to -O3.
+    uint32 opt_level;
+    EmitKind emit;
+    // NULL picks a default name based on `emit`.
+    const char* output_path;
+    // Compile in memory and run `main` instead of emitting anything.
+    bool jit;
+    // Where to keep the IR of every function between runs; NULL turns the cache off.
+    const char* cache_directory;
+    // codegen_run adds phases for the module passes and for emitting or running the code. NULL when nobody asked
+    // for a report.
+    TimeReport* time_report;
+    // Turns on LLVM's timer for every pass. They cost about as much as the passes themselves, so the phase times
+    // aren't comparable with runs that have them off.
+    bool time_passes;
+} CodeGenOptions;
 
 typedef struct CodeGen CodeGen;
 
-CodeGen* codegen_create(const AstContext* ast_context);
-void codegen_run(CodeGen* codegen);
\ No newline at end of file
+// Builds every item of `ast_context`, where function names are interned. Names inside a function's body are looked
+// up in its `FunctionItem::unit`.
+CodeGen* codegen_create(const AstContext* ast_context, const CodeGenOptions* options);
+void codegen_delete(CodeGen* codegen);
+
+// Returns the exit code of `main` when running under the JIT, 0 otherwise.
+int codegen_run(CodeGen* codegen);
+
+// Releases LLVM's global state, after every CodeGen is gone. This is when LLVM prints its pass timings.
+void codegen_shutdown();
\ No newline at end of file
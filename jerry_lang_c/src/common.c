@@ -1,13 +1,103 @@
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "common.h"
 
+#ifdef _WIN32
+#    include <malloc.h>
+#    define heap_block_size(memory) _msize(memory)
+#elif defined(__APPLE__)
+#    include <malloc/malloc.h>
+#    define heap_block_size(memory) malloc_size(memory)
+#else
+#    include <malloc.h>
+#    define heap_block_size(memory) malloc_usable_size(memory)
+#endif
+
+static bool tracking_allocations;
+static uint64 allocation_count;
+static uint64 allocated_bytes;
+static uint64 live_bytes;
+static uint64 peak_live_bytes;
+
+static void raise_peak_live(uint64 live) {
+    uint64 peak = atomic_add_u64(&peak_live_bytes, 0);
+    while (live > peak) {
+#ifdef _WIN32
+        uint64 seen = (uint64) _InterlockedCompareExchange64(
+              (volatile long long*) &peak_live_bytes, (long long) live, (long long) peak);
+        if (seen == peak) {
+            return;
+        }
+        peak = seen;
+#else
+        if (__atomic_compare_exchange_n(&peak_live_bytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return;
+        }
+#endif
+    }
+}
+
+static void count_allocation(size_t bytes, void* memory) {
+    atomic_add_u64(&allocation_count, 1);
+    atomic_add_u64(&allocated_bytes, bytes);
+
+    uint64 size = heap_block_size(memory);
+    raise_peak_live(atomic_add_u64(&live_bytes, size) + size);
+}
+
+static void count_free(void* memory) {
+    atomic_add_u64(&live_bytes, 0 - (uint64) heap_block_size(memory));
+}
+
+void allocation_tracking_start() {
+    tracking_allocations = true;
+}
+
+void allocation_stats(AllocationStats* stats) {
+    stats->count           = atomic_add_u64(&allocation_count, 0);
+    stats->bytes           = atomic_add_u64(&allocated_bytes, 0);
+    stats->live_bytes      = atomic_add_u64(&live_bytes, 0);
+    stats->peak_live_bytes = atomic_add_u64(&peak_live_bytes, 0);
+}
+
+void allocation_reset_peak() {
+    uint64 live = atomic_add_u64(&live_bytes, 0);
+#ifdef _WIN32
+    _InterlockedExchange64((volatile long long*) &peak_live_bytes, (long long) live);
+#else
+    __atomic_store_n(&peak_live_bytes, live, __ATOMIC_RELAXED);
+#endif
+}
+
 void* my_malloc(size_t bytes) {
     void* result = malloc(bytes);
     bail_out_if(result != NULL, "out of memory");
+    if (tracking_allocations) {
+        count_allocation(bytes, result);
+    }
     return result;
 }
 
+void* my_realloc(void* memory, size_t bytes) {
+    if (tracking_allocations && memory) {
+        count_free(memory);
+    }
+    void* result = realloc(memory, bytes);
+    bail_out_if(result != NULL, "out of memory");
+    if (tracking_allocations) {
+        count_allocation(bytes, result);
+    }
+    return result;
+}
+
+void my_free(void* memory) {
+    if (tracking_allocations && memory) {
+        count_free(memory);
+    }
+    free(memory);
+}
+
 static void grow_vector(VectorBase* vector, size_t with) {
     if (vector->size + with <= vector->capacity) {
         return;
@@ -15,7 +105,7 @@ static void grow_vector(VectorBase* vector, size_t with) {
     size_t new_capacity = max(vector->size + with, vector->capacity + vector->capacity / 2);
     uint8* memory       = my_malloc(vector->element_size * new_capacity);
     memcpy(memory, vector->ptr, vector->element_size * vector->size);
-    free(vector->ptr);
+    my_free(vector->ptr);
     vector->ptr      = memory;
     vector->capacity = new_capacity;
 }
@@ -29,12 +119,90 @@ void vector_push_back(void* vector_par, void* element) {
 
 void delete_vector(void* vector_par) {
     VectorBase* vector = (VectorBase*) vector_par;
-    free(vector->ptr);
+    my_free(vector->ptr);
     vector->ptr      = NULL;
     vector->size     = 0;
     vector->capacity = 0;
 }
 
+struct ArenaChunk {
+    ArenaChunk* previous;
+    size_t size;
+    size_t used;
+};
+
+enum { ARENA_MAX_ALIGNMENT = 16 };
+
+static size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint8* arena_chunk_data(ArenaChunk* chunk) {
+    return (uint8*) chunk + align_up(sizeof(ArenaChunk), ARENA_MAX_ALIGNMENT);
+}
+
+static ArenaChunk* arena_new_chunk(Arena* arena, size_t size) {
+    ArenaChunk* chunk = my_malloc(align_up(sizeof(ArenaChunk), ARENA_MAX_ALIGNMENT) + size);
+    chunk->previous   = NULL;
+    chunk->size       = size;
+    chunk->used       = 0;
+
+    arena->bytes_reserved += size;
+    arena->chunks_used++;
+    return chunk;
+}
+
+void arena_create(Arena* arena, size_t chunk_size) {
+    arena->current        = NULL;
+    arena->chunk_size     = chunk_size;
+    arena->bytes_used     = 0;
+    arena->bytes_reserved = 0;
+    arena->chunks_used    = 0;
+}
+
+void* arena_alloc(Arena* arena, size_t bytes, size_t alignment) {
+    bail_out_if(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment is not a power of two");
+    bail_out_if(alignment <= ARENA_MAX_ALIGNMENT, "alignment too big");
+
+    arena->bytes_used += bytes;
+
+    // Allocations that don't fit in a regular chunk get one of their own, linked behind the current one so
+    // we keep bumping into what's left of it.
+    if (bytes > arena->chunk_size / 2) {
+        ArenaChunk* chunk = arena_new_chunk(arena, bytes);
+        chunk->used       = bytes;
+        if (arena->current) {
+            chunk->previous          = arena->current->previous;
+            arena->current->previous = chunk;
+        } else {
+            arena->current = chunk;
+        }
+        return arena_chunk_data(chunk);
+    }
+
+    ArenaChunk* chunk = arena->current;
+    size_t offset     = chunk ? align_up(chunk->used, alignment) : 0;
+    if (chunk == NULL || offset + bytes > chunk->size) {
+        chunk           = arena_new_chunk(arena, arena->chunk_size);
+        chunk->previous = arena->current;
+        arena->current  = chunk;
+        offset          = 0;
+    }
+
+    chunk->used = offset + bytes;
+    return arena_chunk_data(chunk) + offset;
+}
+
+void arena_delete(Arena* arena) {
+    ArenaChunk* chunk = arena->current;
+    while (chunk) {
+        ArenaChunk* previous = chunk->previous;
+        my_free(chunk);
+        chunk = previous;
+    }
+    arena_create(arena, arena->chunk_size);
+}
+
 int string_compare(const char* first, size_t first_size, const char* second, size_t second_size) {
     size_t m = min(first_size, second_size);
     for (size_t i = 0; i < m; ++i) {
@@ -53,3 +221,28 @@ int string_compare(const char* first, size_t first_size, const char* second, siz
     }
     return 0;
 }
+
+// FNV-1a.
+uint32 hash_string(const char* string, size_t size) {
+    uint32 hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= (uint8) string[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint64 hash64_update(uint64 hash, const void* data, size_t size) {
+    const uint8* bytes = data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64 time_now_ns() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (uint64) now.tv_sec * 1000000000 + (uint64) now.tv_nsec;
+}
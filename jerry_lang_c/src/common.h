@@ -7,7 +7,18 @@
 #include <stdint.h>
 #include <string.h>
 
+// MSVC's stdlib.h has these; everywhere else they're ours.
+#ifndef min
+#    define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#    define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
 void* my_malloc(size_t bytes);
+void* my_realloc(void* memory, size_t bytes);
+// For memory from my_malloc/my_realloc, so it stops counting as live.
+void my_free(void* memory);
 
 #define bail_out_if(cond, message)                                                                                     \
     do {                                                                                                               \
@@ -21,8 +32,18 @@ void* my_malloc(size_t bytes);
 
 typedef uint8_t uint8;
 typedef uint16_t uint16;
+typedef uint32_t uint32;
 typedef uint64_t uint64;
 
+// Adds `value` to the uint64 at `target` and returns what was there before. Relaxed, so it only suits counters and
+// handing out indices, not publishing data to other threads.
+#ifdef _WIN32
+#    include <intrin.h>
+#    define atomic_add_u64(target, value) _InterlockedExchangeAdd64((volatile long long*) (target), (long long) (value))
+#else
+#    define atomic_add_u64(target, value) __atomic_fetch_add(target, value, __ATOMIC_RELAXED)
+#endif
+
 #define VECTOR_OF(type, name)                                                                                          \
     typedef struct {                                                                                                   \
         type* ptr;                                                                                                     \
@@ -30,7 +51,7 @@ typedef uint64_t uint64;
         size_t capacity;                                                                                               \
         size_t element_size;                                                                                           \
     } Vector##name;                                                                                                    \
-    inline Vector##name create_vector_##name() {                                                                       \
+    static inline Vector##name create_vector_##name() {                                                                \
         Vector##name vector;                                                                                           \
         vector.ptr          = NULL;                                                                                    \
         vector.size         = 0;                                                                                       \
@@ -50,6 +71,32 @@ void vector_push_back(void* vector, void* element);
 void delete_vector(void* vector);
 
 int string_compare(const char* first, size_t first_size, const char* second, size_t second_size);
+uint32 hash_string(const char* string, size_t size);
+
+#define HASH64_SEED 14695981039346656037ull
+
+// 64-bit FNV-1a, for hashing a stream of pieces: start from HASH64_SEED and feed the result back in.
+uint64 hash64_update(uint64 hash, const void* data, size_t size);
+
+uint64 time_now_ns();
+
+// What went through my_malloc/my_realloc/my_free, from every thread.
+typedef struct AllocationStats {
+    // Calls and the bytes they asked for since the process started.
+    uint64 count;
+    uint64 bytes;
+    // Heap blocks allocated and not freed yet, counted at their real size, and the most of them at once since the
+    // last allocation_reset_peak.
+    uint64 live_bytes;
+    uint64 peak_live_bytes;
+} AllocationStats;
+
+// Off until this is called, so the allocation functions don't touch shared counters unless someone reads them.
+// Call it before anything is allocated and before other threads start; a block allocated earlier would be
+// taken off the live count when it's freed without ever having been added.
+void allocation_tracking_start();
+void allocation_stats(AllocationStats* stats);
+void allocation_reset_peak();
 
 #define array_size(var) sizeof(var) / sizeof(*var)
 
@@ -57,6 +104,24 @@ int string_compare(const char* first, size_t first_size, const char* second, siz
 
 VECTOR_OF(void*, Void);
 
+#define align_of(type) offsetof(struct { char c; type member; }, member)
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena {
+    ArenaChunk* current;
+    size_t chunk_size;
+
+    // Shown by --time-report, to size chunks from real numbers.
+    size_t bytes_used;
+    size_t bytes_reserved;
+    size_t chunks_used;
+} Arena;
+
+void arena_create(Arena* arena, size_t chunk_size);
+void* arena_alloc(Arena* arena, size_t bytes, size_t alignment);
+void arena_delete(Arena* arena);
+
 #define make_string_stack(name_brrr, max_string_size, string, string_size)                                             \
     bail_out_if(string_size + 1 <= max_string_size, "string too big");                                                 \
     char name_brrr[max_string_size];                                                                                   \
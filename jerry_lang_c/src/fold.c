@@ -0,0 +1,239 @@
+#include "fold.h"
+
+#define ast_alloc(type) ast_alloc_in(folder->ast, type)
+
+typedef struct Folder {
+    AstContext* ast;
+} Folder;
+
+static Expr* fold_expr(Folder* folder, Expr* expr);
+
+// Codegen emits plain add/sub/mul, which wrap around at the width of the type whether it's signed or not. Folding
+// in a uint64 and cutting the result down to the width gives the same bits. Wider types are left to LLVM.
+static bool is_foldable_number(const Type* type) {
+    const PrimitiveType* primitive = (const PrimitiveType*) type;
+    return type->kind == TYPE_PRIMITIVE && primitive->kind == PRIMITIVE_NUMBER && primitive->integer_size > 0 &&
+           primitive->integer_size <= 64;
+}
+
+static uint64 wrap_to_type(const Type* type, uint64 value) {
+    uint16 size = ((const PrimitiveType*) type)->integer_size;
+    return size == 64 ? value : value & ((1ull << size) - 1);
+}
+
+static bool as_constant(const Expr* expr, uint64* value) {
+    if (expr->kind != EXPR_INT_LIT || !is_foldable_number(expr->type)) {
+        return false;
+    }
+    *value = wrap_to_type(expr->type, ((const IntLitExpr*) expr)->number);
+    return true;
+}
+
+static Expr* make_int_lit(Folder* folder, Type* type, uint64 value) {
+    const PrimitiveType* primitive = (const PrimitiveType*) type;
+
+    IntLitExpr* lit   = ast_alloc(IntLitExpr);
+    lit->expr.kind    = EXPR_INT_LIT;
+    lit->expr.type    = type;
+    lit->number       = wrap_to_type(type, value);
+    lit->is_unsigned  = primitive->is_unsigned;
+    lit->integer_size = primitive->integer_size;
+    return (Expr*) lit;
+}
+
+static Expr* make_bool_lit(Folder* folder, bool value) {
+    BoolLitExpr* lit = ast_alloc(BoolLitExpr);
+    lit->expr.kind   = EXPR_BOOL_LIT;
+    lit->expr.type   = folder->ast->type_bool;
+    lit->value       = value;
+    return (Expr*) lit;
+}
+
+static Expr* fold_int_lit(Folder* folder, IntLitExpr* integer) {
+    return (Expr*) integer;
+}
+
+static Expr* fold_bool_lit(Folder* folder, BoolLitExpr* boolean) {
+    return (Expr*) boolean;
+}
+
+static Expr* fold_var_ref(Folder* folder, VariableReferenceExpr* var) {
+    return (Expr*) var;
+}
+
+static Expr* fold_paren(Folder* folder, ParenExpr* paren) {
+    return fold_expr(folder, paren->subexpression);
+}
+
+static Expr* fold_unary(Folder* folder, UnaryExpr* unary) {
+    unary->subexpression = fold_expr(folder, unary->subexpression);
+    Expr* subexpression  = unary->subexpression;
+
+    uint64 value;
+    switch (unary->kind) {
+    case UNARY_PLUS:
+        return subexpression;
+    case UNARY_MINUS:
+        if (as_constant(subexpression, &value)) {
+            return make_int_lit(folder, unary->base.type, 0 - value);
+        }
+        if (subexpression->kind == EXPR_UNARY && ((UnaryExpr*) subexpression)->kind == UNARY_MINUS) {
+            return ((UnaryExpr*) subexpression)->subexpression;
+        }
+        return (Expr*) unary;
+    default:
+        return (Expr*) unary;
+    }
+}
+
+static Expr* fold_comparison(Folder* folder, BinaryExpr* binary) {
+    bool equal;
+    uint64 left, right;
+    if (as_constant(binary->left, &left) && as_constant(binary->right, &right)) {
+        equal = left == right;
+    } else if (binary->left->kind == EXPR_BOOL_LIT && binary->right->kind == EXPR_BOOL_LIT) {
+        equal = ((BoolLitExpr*) binary->left)->value == ((BoolLitExpr*) binary->right)->value;
+    } else {
+        return (Expr*) binary;
+    }
+    return make_bool_lit(folder, binary->kind == BINARY_EQ ? equal : !equal);
+}
+
+static bool is_additive(BinaryKind kind) {
+    return kind == BINARY_PLUS || kind == BINARY_MINUS;
+}
+
+// What `x op value` adds to `x`; subtracting is adding the negated value once everything wraps around.
+static uint64 additive_term(BinaryKind kind, uint64 value) {
+    return kind == BINARY_MINUS ? 0 - value : value;
+}
+
+static Expr* simplify_binary(Folder* folder, BinaryExpr* binary);
+
+// `(x + a) - b` becomes `x + (a - b)` and `(x * a) * b` becomes `x * (a * b)`. Wrapping arithmetic is associative,
+// so this holds for every width and signedness. The nested expression was already simplified, so its constant, if
+// any, is on the right.
+static Expr* reassociate(Folder* folder, BinaryExpr* binary, uint64 value) {
+    if (binary->left->kind != EXPR_BINARY) {
+        return (Expr*) binary;
+    }
+    BinaryExpr* inner = (BinaryExpr*) binary->left;
+    uint64 inner_value;
+    if (!as_constant(inner->right, &inner_value)) {
+        return (Expr*) binary;
+    }
+
+    if (is_additive(binary->kind) && is_additive(inner->kind)) {
+        uint64 sum   = additive_term(inner->kind, inner_value) + additive_term(binary->kind, value);
+        inner->kind  = BINARY_PLUS;
+        inner->right = make_int_lit(folder, inner->expr.type, sum);
+        return simplify_binary(folder, inner);
+    }
+    if (binary->kind == BINARY_MUL && inner->kind == BINARY_MUL) {
+        inner->right = make_int_lit(folder, inner->expr.type, inner_value * value);
+        return simplify_binary(folder, inner);
+    }
+    return (Expr*) binary;
+}
+
+// At most one side is a constant here. Dropping the other side of `x * 0` is only fine because expressions can't
+// have side effects yet.
+static Expr* simplify_binary(Folder* folder, BinaryExpr* binary) {
+    uint64 value;
+    if (as_constant(binary->left, &value)) {
+        if (binary->kind == BINARY_PLUS && value == 0) {
+            return binary->right;
+        }
+        if (binary->kind == BINARY_MUL && value == 1) {
+            return binary->right;
+        }
+        if (binary->kind == BINARY_MUL && value == 0) {
+            return binary->left;
+        }
+        if (binary->kind != BINARY_PLUS && binary->kind != BINARY_MUL) {
+            return (Expr*) binary;
+        }
+        // Keep constants on the right, where `reassociate` looks for them.
+        Expr* constant = binary->left;
+        binary->left   = binary->right;
+        binary->right  = constant;
+    }
+
+    if (!as_constant(binary->right, &value)) {
+        return (Expr*) binary;
+    }
+    if (is_additive(binary->kind) && value == 0) {
+        return binary->left;
+    }
+    if (binary->kind == BINARY_MUL && value == 1) {
+        return binary->left;
+    }
+    if (binary->kind == BINARY_MUL && value == 0) {
+        return binary->right;
+    }
+    return reassociate(folder, binary, value);
+}
+
+static Expr* fold_binary(Folder* folder, BinaryExpr* binary) {
+    binary->left  = fold_expr(folder, binary->left);
+    binary->right = fold_expr(folder, binary->right);
+
+    if (binary->kind == BINARY_EQ || binary->kind == BINARY_NOT_EQ) {
+        return fold_comparison(folder, binary);
+    }
+    if (!is_foldable_number(binary->expr.type)) {
+        return (Expr*) binary;
+    }
+
+    uint64 left, right;
+    if (as_constant(binary->left, &left) && as_constant(binary->right, &right)) {
+        switch (binary->kind) {
+        case BINARY_PLUS:
+            return make_int_lit(folder, binary->expr.type, left + right);
+        case BINARY_MINUS:
+            return make_int_lit(folder, binary->expr.type, left - right);
+        case BINARY_MUL:
+            return make_int_lit(folder, binary->expr.type, left * right);
+        default:
+            // Division isn't folded until codegen decides what it does for signed values and zero.
+            return (Expr*) binary;
+        }
+    }
+    return simplify_binary(folder, binary);
+}
+
+static Expr* fold_expr(Folder* folder, Expr* expr) {
+    ITERATE_EXPRS(ITERATE_DEFAULT_RETURN, expr, fold, folder);
+}
+
+static void fold_var_assign(Folder* folder, VariableAssignment* assign) {
+    assign->init = fold_expr(folder, assign->init);
+}
+
+static void fold_return(Folder* folder, ReturnStmt* return_stmt) {
+    if (return_stmt->subexpr) {
+        return_stmt->subexpr = fold_expr(folder, return_stmt->subexpr);
+    }
+}
+
+static void fold_stmt(Folder* folder, Stmt* stmt) {
+    ITERATE_STMTS(ITERATE_DEFAULT_RETURN_VOID, stmt, fold, folder);
+}
+
+static void fold_function(Folder* folder, FunctionItem* function) {
+    Block* block = function->block;
+    for (size_t i = 0; i < block->stmts_size; ++i) {
+        fold_stmt(folder, block->stmts[i]);
+    }
+}
+
+static void fold_item(Folder* folder, Item* item) {
+    ITERATE_ITEMS(ITERATE_DEFAULT_RETURN_VOID, item, fold, folder);
+}
+
+void fold_constants(AstContext* ast) {
+    Folder folder = { .ast = ast };
+    for (size_t i = 0; i < ast->items_size; ++i) {
+        fold_item(&folder, ast->items[i]);
+    }
+}
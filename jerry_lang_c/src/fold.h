@@ -0,0 +1,7 @@
+#pragma once
+
+#include "ast.h"
+
+// Replaces constant subexpressions with literals and drops identity operations like `x + 0` and `x * 1`. Runs on
+// the typed AST, between parsing and codegen.
+void fold_constants(AstContext* ast);
@@ -0,0 +1,168 @@
+#include "input.h"
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <fcntl.h>
+#    include <io.h>
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+static bool is_stdin_path(const char* path) {
+    return strcmp(path, "-") == 0;
+}
+
+#ifdef _WIN32
+
+static void open_platform(SourceFile* source) {
+    HANDLE file = CreateFileA(
+          source->path,
+          GENERIC_READ,
+          FILE_SHARE_READ,
+          NULL,
+          OPEN_EXISTING,
+          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+          NULL);
+    bail_out_if(file != INVALID_HANDLE_VALUE, "can't read file");
+
+    if (GetFileType(file) != FILE_TYPE_DISK) {
+        CloseHandle(file);
+        source->stream = fopen(source->path, "rb");
+        bail_out_if(source->stream != NULL, "can't read file");
+        source->is_stream = true;
+        return;
+    }
+
+    LARGE_INTEGER size;
+    bail_out_if(GetFileSizeEx(file, &size), "can't get file size");
+    source->file_handle = file;
+    source->size        = (size_t) size.QuadPart;
+    if (source->size == 0) {
+        source->text = "";
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping != NULL) {
+        const char* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view != NULL) {
+            source->mapping_handle = mapping;
+            source->text           = view;
+            source->is_mapped      = true;
+            return;
+        }
+        CloseHandle(mapping);
+    }
+
+    char* text = my_malloc(source->size);
+    DWORD read = 0;
+    bail_out_if(source->size <= MAXDWORD, "file too big to read");
+    bail_out_if(ReadFile(file, text, (DWORD) source->size, &read, NULL) && read == source->size, "can't read file");
+    source->text = text;
+}
+
+static void close_platform(SourceFile* source) {
+    if (source->is_mapped) {
+        UnmapViewOfFile(source->text);
+        CloseHandle(source->mapping_handle);
+    } else if (source->size > 0) {
+        my_free((char*) source->text);
+    }
+    if (source->file_handle) {
+        CloseHandle(source->file_handle);
+    }
+}
+
+#else
+
+static void open_platform(SourceFile* source) {
+    int fd = open(source->path, O_RDONLY);
+    bail_out_if(fd >= 0, "can't read file");
+
+    struct stat info;
+    bail_out_if(fstat(fd, &info) == 0, "can't stat file");
+    if (!S_ISREG(info.st_mode)) {
+        source->stream = fdopen(fd, "rb");
+        bail_out_if(source->stream != NULL, "can't read file");
+        source->is_stream = true;
+        return;
+    }
+
+    source->fd   = fd;
+    source->size = (size_t) info.st_size;
+    if (source->size == 0) {
+        source->text = "";
+        return;
+    }
+
+    void* view = mmap(NULL, source->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view != MAP_FAILED) {
+        madvise(view, source->size, MADV_SEQUENTIAL);
+        source->text      = view;
+        source->is_mapped = true;
+        return;
+    }
+
+    char* text  = my_malloc(source->size);
+    size_t done = 0;
+    while (done < source->size) {
+        ssize_t ret = read(fd, text + done, source->size - done);
+        bail_out_if(ret > 0, "can't read file");
+        done += (size_t) ret;
+    }
+    source->text = text;
+}
+
+static void close_platform(SourceFile* source) {
+    if (source->is_mapped) {
+        munmap((void*) source->text, source->size);
+    } else if (source->size > 0) {
+        my_free((char*) source->text);
+    }
+    if (source->fd >= 0) {
+        close(source->fd);
+    }
+}
+
+#endif
+
+void source_file_open(SourceFile* source, const char* path) {
+    memset(source, 0, sizeof(*source));
+    source->path = path;
+#ifndef _WIN32
+    source->fd = -1;
+#endif
+
+    if (is_stdin_path(path)) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        source->stream    = stdin;
+        source->is_stream = true;
+        return;
+    }
+
+    open_platform(source);
+}
+
+void source_file_close(SourceFile* source) {
+    if (source->is_stream) {
+        if (source->stream != stdin) {
+            fclose(source->stream);
+        }
+        return;
+    }
+    close_platform(source);
+}
+
+void source_file_create_lexer(SourceFile* source, Lexer* lexer) {
+    if (source->is_stream) {
+        lexer_create_file(lexer, source->stream, LEXER_BUFFER_SIZE);
+    } else {
+        lexer_create_text(lexer, source->text, source->size);
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "common.h"
+#include "lexer.h"
+
+// A source file opened for lexing. Regular files are mapped read-only and lexed in place; if mapping fails
+// they're read with a single `read` sized by `fstat`. Pipes and stdin (path "-") can't be mapped or sized up
+// front, so they're streamed through the lexer's buffer instead.
+typedef struct SourceFile {
+    const char* path;
+    const char* text;
+    size_t size;
+
+    bool is_mapped;
+    bool is_stream;
+    FILE* stream;
+
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#else
+    int fd;
+#endif
+} SourceFile;
+
+void source_file_open(SourceFile* source, const char* path);
+void source_file_close(SourceFile* source);
+
+void source_file_create_lexer(SourceFile* source, Lexer* lexer);
@@ -0,0 +1,107 @@
+#include "interner.h"
+
+enum {
+    INTERNER_INITIAL_CAPACITY = 256,
+    INTERNER_INITIAL_POOL     = 4096,
+};
+
+static uint32* allocate_slots(size_t capacity) {
+    uint32* slots = my_malloc(capacity * sizeof(uint32));
+    memset(slots, 0, capacity * sizeof(uint32));
+    return slots;
+}
+
+void interner_create(Interner* interner) {
+    interner->pool_capacity = INTERNER_INITIAL_POOL;
+    interner->pool          = my_malloc(interner->pool_capacity);
+    interner->pool_size     = 0;
+    interner->strings       = create_vector_InternedString();
+    interner->capacity      = INTERNER_INITIAL_CAPACITY;
+    interner->slots         = allocate_slots(interner->capacity);
+}
+
+void interner_delete(Interner* interner) {
+    my_free(interner->pool);
+    my_free(interner->slots);
+    interner->pool  = NULL;
+    interner->slots = NULL;
+    delete_vector(&interner->strings);
+}
+
+static uint32* find_slot(const Interner* interner, const char* string, size_t size, uint32 hash) {
+    size_t mask = interner->capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint32* slot = interner->slots + i;
+        if (*slot == 0) {
+            return slot;
+        }
+        const InternedString* current = interner->strings.ptr + (*slot - 1);
+        if (current->hash == hash && current->size == size &&
+            memcmp(interner->pool + current->offset, string, size) == 0) {
+            return slot;
+        }
+    }
+}
+
+static void grow_slots(Interner* interner) {
+    my_free(interner->slots);
+    interner->capacity *= 2;
+    interner->slots = allocate_slots(interner->capacity);
+
+    size_t mask = interner->capacity - 1;
+    for (size_t symbol = 0; symbol < interner->strings.size; ++symbol) {
+        size_t i = interner->strings.ptr[symbol].hash & mask;
+        while (interner->slots[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        interner->slots[i] = (uint32) symbol + 1;
+    }
+}
+
+static uint32 append_to_pool(Interner* interner, const char* string, size_t size) {
+    size_t needed = interner->pool_size + size + 1;
+    bail_out_if(needed <= UINT32_MAX, "string pool too big");
+    if (needed > interner->pool_capacity) {
+        while (needed > interner->pool_capacity) {
+            interner->pool_capacity *= 2;
+        }
+        interner->pool = my_realloc(interner->pool, interner->pool_capacity);
+    }
+
+    uint32 offset = (uint32) interner->pool_size;
+    memcpy(interner->pool + offset, string, size);
+    interner->pool[offset + size] = '\0';
+    interner->pool_size           = needed;
+    return offset;
+}
+
+Symbol intern(Interner* interner, const char* string, size_t size) {
+    uint32 hash  = hash_string(string, size);
+    uint32* slot = find_slot(interner, string, size, hash);
+    if (*slot != 0) {
+        return *slot - 1;
+    }
+
+    uint32 offset           = append_to_pool(interner, string, size);
+    InternedString interned = { .offset = offset, .size = (uint32) size, .hash = hash };
+    vector_push_back(&interner->strings, &interned);
+    Symbol symbol = (Symbol) (interner->strings.size - 1);
+    *slot         = symbol + 1;
+
+    if (interner->strings.size * 4 > interner->capacity * 3) {
+        grow_slots(interner);
+    }
+    return symbol;
+}
+
+const char* interner_string(const Interner* interner, Symbol symbol) {
+    return interner->pool + interner->strings.ptr[symbol].offset;
+}
+
+size_t interner_string_size(const Interner* interner, Symbol symbol) {
+    return interner->strings.ptr[symbol].size;
+}
+
+size_t interner_symbol_count(const Interner* interner) {
+    return interner->strings.size;
+}
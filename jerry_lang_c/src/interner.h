@@ -0,0 +1,38 @@
+#pragma once
+
+#include "common.h"
+
+// Dense id of an interned string; equal strings always get the same symbol.
+typedef uint32 Symbol;
+
+typedef struct InternedString {
+    uint32 offset;
+    uint32 size;
+    uint32 hash;
+} InternedString;
+
+VECTOR_OF(InternedString, InternedString);
+
+typedef struct Interner {
+    // Every string, NUL terminated, back to back.
+    char* pool;
+    size_t pool_size;
+    size_t pool_capacity;
+
+    // Indexed by symbol.
+    VectorInternedString strings;
+
+    // Open addressing table of symbol + 1; 0 marks an empty slot.
+    uint32* slots;
+    size_t capacity;
+} Interner;
+
+void interner_create(Interner* interner);
+void interner_delete(Interner* interner);
+
+Symbol intern(Interner* interner, const char* string, size_t size);
+
+// The pool can move when a new string is interned, so don't keep the pointer across calls to intern.
+const char* interner_string(const Interner* interner, Symbol symbol);
+size_t interner_string_size(const Interner* interner, Symbol symbol);
+size_t interner_symbol_count(const Interner* interner);
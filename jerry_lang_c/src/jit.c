@@ -0,0 +1,112 @@
+#include "jit.h"
+
+#if JIT_SUPPORTED
+
+#    include <llvm-c/LLJIT.h>
+#    include <llvm-c/Target.h>
+#    include "runtime.h"
+
+// A JitContext is the thread-safe context itself, so no wrapper has to be allocated.
+static LLVMOrcThreadSafeContextRef thread_safe_context(JitContext* context) {
+    return (LLVMOrcThreadSafeContextRef) context;
+}
+
+JitContext* jit_context_create() {
+    return (JitContext*) LLVMOrcCreateNewThreadSafeContext();
+}
+
+void jit_context_delete(JitContext* context) {
+    LLVMOrcDisposeThreadSafeContext(thread_safe_context(context));
+}
+
+LLVMContextRef jit_context_llvm(JitContext* context) {
+    return LLVMOrcThreadSafeContextGetContext(thread_safe_context(context));
+}
+
+static void bail_out_on_orc_error(LLVMErrorRef error, const char* message) {
+    if (error) {
+        char* text = LLVMGetErrorMessage(error);
+        fprintf(stderr, "%s\n", text);
+        LLVMDisposeErrorMessage(text);
+        bail_out(message);
+    }
+}
+
+static LLVMJITCSymbolMapPair runtime_symbol(LLVMOrcLLJITRef jit, const char* name, LLVMOrcExecutorAddress address) {
+    LLVMJITCSymbolMapPair pair;
+    pair.Name                   = LLVMOrcLLJITMangleAndIntern(jit, name);
+    pair.Sym.Address            = address;
+    pair.Sym.Flags.GenericFlags = LLVMJITSymbolGenericFlagsExported | LLVMJITSymbolGenericFlagsCallable;
+    pair.Sym.Flags.TargetFlags  = 0;
+    return pair;
+}
+
+// The runtime lives in the executable, which doesn't export its symbols, so they're defined explicitly.
+static void define_runtime(LLVMOrcLLJITRef jit, LLVMOrcJITDylibRef dylib) {
+    LLVMJITCSymbolMapPair symbols[] = {
+        runtime_symbol(jit, "println_string", (LLVMOrcExecutorAddress) (uintptr_t) println_string),
+        runtime_symbol(jit, "println_number", (LLVMOrcExecutorAddress) (uintptr_t) println_number),
+    };
+    LLVMOrcMaterializationUnitRef unit = LLVMOrcAbsoluteSymbols(symbols, array_size(symbols));
+    bail_out_on_orc_error(LLVMOrcJITDylibDefine(dylib, unit), "can't define runtime symbols");
+}
+
+uint64 jit_run(JitContext* context, LLVMModuleRef module, const char* entry) {
+    LLVMInitializeNativeTarget();
+    LLVMInitializeNativeAsmPrinter();
+
+    LLVMOrcLLJITRef jit;
+    bail_out_on_orc_error(LLVMOrcCreateLLJIT(&jit, NULL), "can't create jit");
+
+    LLVMOrcJITDylibRef dylib = LLVMOrcLLJITGetMainJITDylib(jit);
+    define_runtime(jit, dylib);
+
+    LLVMOrcDefinitionGeneratorRef process_symbols;
+    bail_out_on_orc_error(
+          LLVMOrcCreateDynamicLibrarySearchGeneratorForProcess(
+                &process_symbols, LLVMOrcLLJITGetGlobalPrefix(jit), NULL, NULL),
+          "can't search process symbols");
+    LLVMOrcJITDylibAddGenerator(dylib, process_symbols);
+
+    LLVMOrcThreadSafeModuleRef thread_safe_module =
+          LLVMOrcCreateNewThreadSafeModule(module, thread_safe_context(context));
+    bail_out_on_orc_error(LLVMOrcLLJITAddLLVMIRModule(jit, dylib, thread_safe_module), "can't add module to jit");
+
+    LLVMOrcExecutorAddress address;
+    bail_out_on_orc_error(LLVMOrcLLJITLookup(jit, &address, entry), "can't find entry point");
+
+    uint64 (*function)() = (uint64(*)()) (uintptr_t) address;
+    uint64 result        = function();
+
+    bail_out_on_orc_error(LLVMOrcDisposeLLJIT(jit), "can't dispose jit");
+    return result;
+}
+
+#else
+
+// main rejects --jit before anything gets here; these only keep the linker happy.
+
+JitContext* jit_context_create() {
+    bail_out(JIT_UNSUPPORTED_MESSAGE);
+    return NULL;
+}
+
+void jit_context_delete(JitContext* context) {
+    (void) context;
+}
+
+LLVMContextRef jit_context_llvm(JitContext* context) {
+    (void) context;
+    bail_out(JIT_UNSUPPORTED_MESSAGE);
+    return NULL;
+}
+
+uint64 jit_run(JitContext* context, LLVMModuleRef module, const char* entry) {
+    (void) context;
+    (void) module;
+    (void) entry;
+    bail_out(JIT_UNSUPPORTED_MESSAGE);
+    return 0;
+}
+
+#endif
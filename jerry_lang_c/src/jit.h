@@ -0,0 +1,22 @@
+#pragma once
+
+#include <llvm-c/Core.h>
+#include <llvm/Config/llvm-config.h>
+#include "common.h"
+
+// The LLJIT C API used here (LLVMOrcExecutorAddress, LLVMOrcAbsoluteSymbols, LLVMOrcLLJITMangleAndIntern) first
+// shipped in LLVM 13. Against an older LLVM the compiler still builds, and --jit is rejected.
+#define JIT_SUPPORTED (LLVM_VERSION_MAJOR >= 13)
+#define JIT_UNSUPPORTED_MESSAGE "--jit isn't supported with this LLVM, it needs LLVM 13 or later"
+
+// An LLVM context the JIT can take modules from without copying them.
+typedef struct JitContext JitContext;
+
+JitContext* jit_context_create();
+void jit_context_delete(JitContext* context);
+LLVMContextRef jit_context_llvm(JitContext* context);
+
+// Compiles `module` in memory and calls `entry` with no arguments, returning whatever it left in the return
+// register. `module` has to belong to `context` and is owned by the JIT afterwards. Runtime functions and
+// anything else the module doesn't define are resolved from this process.
+uint64 jit_run(JitContext* context, LLVMModuleRef module, const char* entry);
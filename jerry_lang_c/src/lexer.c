@@ -1,69 +1,136 @@
 #include "lexer.h"
-
-typedef struct {
-    VectorToken tokens;
-    const char* text;
-    size_t text_size;
-    size_t offset;
-} Lexer;
-
-static bool is_letter(char ch) {
-    return ('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z');
+#include "scan.h"
+
+typedef enum CharClass {
+    CHAR_LETTER = 1 << 0,
+    CHAR_DIGIT  = 1 << 1,
+    CHAR_IDENT  = 1 << 2,
+    CHAR_SPACE  = 1 << 3,
+    CHAR_PUNCT  = 1 << 4,
+} CharClass;
+
+#define LETTER (CHAR_LETTER | CHAR_IDENT)
+#define DIGIT  (CHAR_DIGIT | CHAR_IDENT)
+
+static const uint8 char_classes[256] = {
+    ['\t'] = CHAR_SPACE, ['\n'] = CHAR_SPACE, ['\r'] = CHAR_SPACE, [' '] = CHAR_SPACE,
+
+    ['('] = CHAR_PUNCT, [')'] = CHAR_PUNCT, ['{'] = CHAR_PUNCT, ['}'] = CHAR_PUNCT, [','] = CHAR_PUNCT,
+    [':'] = CHAR_PUNCT, [';'] = CHAR_PUNCT, ['&'] = CHAR_PUNCT, ['<'] = CHAR_PUNCT, ['='] = CHAR_PUNCT,
+    ['>'] = CHAR_PUNCT, ['+'] = CHAR_PUNCT, ['-'] = CHAR_PUNCT, ['*'] = CHAR_PUNCT, ['/'] = CHAR_PUNCT,
+    ['!'] = CHAR_PUNCT,
+
+    ['_'] = CHAR_IDENT,
+    ['0'] = DIGIT, ['1'] = DIGIT, ['2'] = DIGIT, ['3'] = DIGIT, ['4'] = DIGIT,
+    ['5'] = DIGIT, ['6'] = DIGIT, ['7'] = DIGIT, ['8'] = DIGIT, ['9'] = DIGIT,
+    ['a'] = LETTER, ['b'] = LETTER, ['c'] = LETTER, ['d'] = LETTER, ['e'] = LETTER, ['f'] = LETTER,
+    ['g'] = LETTER, ['h'] = LETTER, ['i'] = LETTER, ['j'] = LETTER, ['k'] = LETTER, ['l'] = LETTER,
+    ['m'] = LETTER, ['n'] = LETTER, ['o'] = LETTER, ['p'] = LETTER, ['q'] = LETTER, ['r'] = LETTER,
+    ['s'] = LETTER, ['t'] = LETTER, ['u'] = LETTER, ['v'] = LETTER, ['w'] = LETTER, ['x'] = LETTER,
+    ['y'] = LETTER, ['z'] = LETTER, ['A'] = LETTER, ['B'] = LETTER, ['C'] = LETTER, ['D'] = LETTER,
+    ['E'] = LETTER, ['F'] = LETTER, ['G'] = LETTER, ['H'] = LETTER, ['I'] = LETTER, ['J'] = LETTER,
+    ['K'] = LETTER, ['L'] = LETTER, ['M'] = LETTER, ['N'] = LETTER, ['O'] = LETTER, ['P'] = LETTER,
+    ['Q'] = LETTER, ['R'] = LETTER, ['S'] = LETTER, ['T'] = LETTER, ['U'] = LETTER, ['V'] = LETTER,
+    ['W'] = LETTER, ['X'] = LETTER, ['Y'] = LETTER, ['Z'] = LETTER,
+};
+
+#undef LETTER
+#undef DIGIT
+
+// Punctuation that can stand on its own.
+static const uint8 single_char_tokens[256] = {
+    ['('] = TOKEN_OPEN_PAREN, [')'] = TOKEN_CLOSED_PAREN, ['{'] = TOKEN_OPEN_BRACE, ['}'] = TOKEN_CLOSED_BRACE,
+    [','] = TOKEN_COMMA,      [':'] = TOKEN_COLON,        [';'] = TOKEN_SEMI,       ['&'] = TOKEN_AMPERSAND,
+    ['<'] = TOKEN_LESS,       ['='] = TOKEN_EQUAL,        ['>'] = TOKEN_GREATER,    ['+'] = TOKEN_PLUS,
+    ['-'] = TOKEN_MINUS,      ['*'] = TOKEN_STAR,         ['/'] = TOKEN_SLASH,      ['!'] = TOKEN_NOT,
+};
+
+// Characters that can continue an operator, and the column they select in `double_char_tokens`.
+enum { SECOND_NONE, SECOND_EQUAL, SECOND_GREATER, SECOND_SIZE };
+
+static const uint8 second_char_columns[256] = { ['='] = SECOND_EQUAL, ['>'] = SECOND_GREATER };
+
+static const uint8 double_char_tokens[256][SECOND_SIZE] = {
+    ['='] = { [SECOND_EQUAL] = TOKEN_DOUBLE_EQUAL },
+    ['<'] = { [SECOND_EQUAL] = TOKEN_LESS_EQUAL },
+    ['>'] = { [SECOND_EQUAL] = TOKEN_GREATER_EQUAL },
+    ['+'] = { [SECOND_EQUAL] = TOKEN_PLUS_EQUAL },
+    ['-'] = { [SECOND_EQUAL] = TOKEN_MINUS_EQUAL, [SECOND_GREATER] = TOKEN_ARROW },
+    ['*'] = { [SECOND_EQUAL] = TOKEN_STAR_EQUAL },
+    ['/'] = { [SECOND_EQUAL] = TOKEN_SLASH_EQUAL },
+    ['!'] = { [SECOND_EQUAL] = TOKEN_NOT_EQUAL },
+};
+
+static uint8 char_class(char ch) {
+    return char_classes[(uint8) ch];
 }
 
 static bool is_number(char ch) {
-    return '0' <= ch && ch <= '9';
-}
-
-static bool is_space(char ch) {
-    return strchr(" \n\r\t", ch);
-}
-
-static bool is_ident_char(char ch) {
-    return is_letter(ch) || is_number(ch) || ch == '_';
+    return char_class(ch) & CHAR_DIGIT;
 }
 
-static bool is_special(char ch) {
-    return strchr("(){},:;&", ch);
+static Token make_token(TokenType type, size_t offset, size_t size) {
+    Token result = { .type = (uint32) type, .offset = (uint32) offset, .size = (uint32) size };
+    return result;
 }
 
-static bool is_operator(char ch) {
-    return strchr("<=>+-*/!", ch);
+// The switch in get_ident_type already matched the length and the first character.
+static TokenType keyword_or_ident(const char* text, const char* keyword, size_t size, TokenType type) {
+    return memcmp(text + 1, keyword + 1, size - 1) == 0 ? type : TOKEN_IDENT;
 }
 
-typedef struct {
-    const char* name;
-    enum TokenType type;
-} TokenTypeData;
-
-enum TokenType get_ident_type(const char* text, size_t size) {
-    TokenTypeData keywords[] = { { .name = "fn", .type = TOKEN_FN },
-                                 { .name = "let", .type = TOKEN_LET },
-                                 { .name = "return", .type = TOKEN_RETURN },
-                                 { .name = "true", .type = TOKEN_TRUE },
-                                 { .name = "false", .type = TOKEN_FALSE } };
-
-    for (size_t i = 0; i < array_size(keywords); ++i) {
-        if (string_compare(text, size, keywords[i].name, strlen(keywords[i].name)) == 0) {
-            return keywords[i].type;
+// Dispatches on length, then on the first character, so at most one keyword is ever compared no matter how many
+// the language has. A keyword that shares its length with another one, like `if` with `fn`, gets its own case in
+// the inner switch.
+static TokenType get_ident_type(const char* text, size_t size) {
+    switch (size) {
+    case 2:
+        switch (text[0]) {
+        case 'f':
+            return keyword_or_ident(text, "fn", 2, TOKEN_FN);
+        default:
+            return TOKEN_IDENT;
+        }
+    case 3:
+        switch (text[0]) {
+        case 'l':
+            return keyword_or_ident(text, "let", 3, TOKEN_LET);
+        default:
+            return TOKEN_IDENT;
+        }
+    case 4:
+        switch (text[0]) {
+        case 't':
+            return keyword_or_ident(text, "true", 4, TOKEN_TRUE);
+        default:
+            return TOKEN_IDENT;
+        }
+    case 5:
+        switch (text[0]) {
+        case 'f':
+            return keyword_or_ident(text, "false", 5, TOKEN_FALSE);
+        default:
+            return TOKEN_IDENT;
         }
+    case 6:
+        switch (text[0]) {
+        case 'r':
+            return keyword_or_ident(text, "return", 6, TOKEN_RETURN);
+        default:
+            return TOKEN_IDENT;
+        }
+    default:
+        return TOKEN_IDENT;
     }
-    return TOKEN_IDENT;
 }
 
 static Token parse_ident(Lexer* lexer) {
     size_t start_offset = lexer->offset;
-    for (; lexer->offset < lexer->text_size; ++lexer->offset) {
-        char current = lexer->text[lexer->offset];
-        if (!is_ident_char(current)) {
-            break;
-        }
-    }
+    lexer->offset       = scan_ident(lexer->text, lexer->offset, lexer->text_size);
 
-    size_t size         = lexer->offset - start_offset;
-    enum TokenType type = get_ident_type(lexer->text + start_offset, size);
-    Token result        = { .type = type, .offset = start_offset, .size = size };
-    return result;
+    size_t size    = lexer->offset - start_offset;
+    TokenType type = get_ident_type(lexer->text + start_offset, size);
+    return make_token(type, start_offset, size);
 }
 
 static Token parse_number(Lexer* lexer) {
@@ -74,7 +141,9 @@ static Token parse_number(Lexer* lexer) {
             break;
         }
     }
-    bail_out_if(lexer->offset < lexer->text_size, "not enough");
+    if (lexer->offset == lexer->text_size) {
+        return make_token(TOKEN_INTEGER, start_offset, lexer->offset - start_offset);
+    }
 
     char specifier = lexer->text[lexer->offset];
 
@@ -89,285 +158,260 @@ static Token parse_number(Lexer* lexer) {
         }
     }
 
-    size_t size         = lexer->offset - start_offset;
-    enum TokenType type = get_ident_type(lexer->text + start_offset, size);
-    Token result        = { .type = TOKEN_INTEGER, .offset = start_offset, .size = size };
-    return result;
+    size_t size = lexer->offset - start_offset;
+    return make_token(TOKEN_INTEGER, start_offset, size);
 }
 
 static Token parse_space(Lexer* lexer) {
     size_t start_offset = lexer->offset;
-    for (; lexer->offset < lexer->text_size; ++lexer->offset) {
-        char current = lexer->text[lexer->offset];
-        if (!is_space(current)) {
-            break;
-        }
-    }
+    lexer->offset       = scan_space(lexer->text, lexer->offset, lexer->text_size);
 
-    size_t size  = lexer->offset - start_offset;
-    Token result = { .type = TOKEN_SPACE, .offset = start_offset, .size = size };
-    return result;
+    size_t size = lexer->offset - start_offset;
+    return make_token(TOKEN_SPACE, start_offset, size);
 }
 
-static Token parse_special(Lexer* lexer) {
-    char current = lexer->text[lexer->offset];
-
-    enum TokenType type;
-    switch (current) {
-    case '(':
-        type = TOKEN_OPEN_PAREN;
-        break;
-    case ')':
-        type = TOKEN_CLOSED_PAREN;
-        break;
-    case ':':
-        type = TOKEN_COLON;
-        break;
-    case ';':
-        type = TOKEN_SEMI;
-        break;
-    case '{':
-        type = TOKEN_OPEN_BRACE;
-        break;
-    case '}':
-        type = TOKEN_CLOSED_BRACE;
-        break;
-    case ',':
-        type = TOKEN_COMMA;
-        break;
-    case '*':
-        type = TOKEN_STAR;
-        break;
-    case '/':
-        type = TOKEN_SLASH;
-        break;
-    case '&':
-        type = TOKEN_AMPERSAND;
-        break;
-    default:
-        bail_out("unknown special");
-    }
+static Token parse_punct(Lexer* lexer) {
+    uint8 current = (uint8) lexer->text[lexer->offset];
+    uint8 next    = lexer->offset + 1 < lexer->text_size ? (uint8) lexer->text[lexer->offset + 1] : '\0';
 
-    Token result = { .type = type, .offset = lexer->offset, .size = 1 };
-    lexer->offset++;
-    return result;
-}
-
-static Token parse_operator(Lexer* lexer) {
-    char current          = lexer->text[lexer->offset];
-    bool maybe_has_second = lexer->offset + 1 < lexer->text_size;
-    char next             = maybe_has_second ? lexer->text[lexer->offset + 1] : '\0';
-
-    enum TokenType type;
-    bool has_second = false;
-    if (current == '=') {
-        if (next == '=') {
-            type       = TOKEN_DOUBLE_EQUAL;
-            has_second = true;
-        } else {
-            type = TOKEN_EQUAL;
-        }
-    } else if (current == '<') {
-        if (next == '=') {
-            type       = TOKEN_LESS_EQUAL;
-            has_second = true;
-        } else {
-            type = TOKEN_LESS;
-        }
-    } else if (current == '>') {
-        if (next == '=') {
-            type       = TOKEN_GREATER_EQUAL;
-            has_second = true;
-        } else {
-            type = TOKEN_GREATER;
-        }
-    } else if (current == '+') {
-        if (next == '=') {
-            type       = TOKEN_PLUS_EQUAL;
-            has_second = true;
-        } else {
-            type = TOKEN_PLUS;
-        }
-    } else if (current == '-') {
-        if (next == '=') {
-            type       = TOKEN_MINUS_EQUAL;
-            has_second = true;
-        } else if (next == '>') {
-            type       = TOKEN_ARROW;
-            has_second = true;
-        } else {
-            type = TOKEN_MINUS;
-        }
-    } else if (current == '*') {
-        if (next == '=') {
-            type       = TOKEN_STAR_EQUAL;
-            has_second = true;
-        } else {
-            type = TOKEN_STAR;
-        }
-    } else if (current == '/') {
-        if (next == '=') {
-            type       = TOKEN_SLASH_EQUAL;
-            has_second = true;
-        } else {
-            type = TOKEN_SLASH;
-        }
-    } else if (current == '!') {
-        if (next == '=') {
-            type       = TOKEN_NOT_EQUAL;
-            has_second = true;
-        } else {
-            type = TOKEN_NOT;
-        }
-    } else {
-        bail_out("unknown operator");
+    TokenType type = double_char_tokens[current][second_char_columns[next]];
+    size_t size    = 2;
+    if (type == TOKEN_NOTHING) {
+        type = single_char_tokens[current];
+        size = 1;
     }
 
-    Token result = { .type = type, .offset = lexer->offset, .size = 1 + (size_t) has_second };
-    lexer->offset += 1 + (size_t) has_second;
+    Token result = make_token(type, lexer->offset, size);
+    lexer->offset += size;
     return result;
 }
 
 static Token parse_one(Lexer* lexer) {
-    char current = lexer->text[lexer->offset];
-    if (is_letter(current)) {
+    uint8 class = char_class(lexer->text[lexer->offset]);
+    if (class & CHAR_LETTER) {
         return parse_ident(lexer);
     }
-    if (is_number(current)) {
+    if (class & CHAR_DIGIT) {
         return parse_number(lexer);
     }
-    if (is_space(current)) {
+    if (class & CHAR_SPACE) {
         return parse_space(lexer);
     }
-    if (is_special(current)) {
-        return parse_special(lexer);
-    }
-    if (is_operator(current)) {
-        return parse_operator(lexer);
+    if (class & CHAR_PUNCT) {
+        return parse_punct(lexer);
     }
 
     bail_out("unknown token");
 }
 
-VectorToken parse_tokens(const char* text, size_t text_size) {
-    Lexer lexer = { .text = text, .text_size = text_size, .tokens = create_vector_Token(), .offset = 0 };
+void lexer_create_text(Lexer* lexer, const char* text, size_t text_size) {
+    bail_out_if(text_size <= MAX_SOURCE_SIZE, "source file too big");
+
+    memset(lexer, 0, sizeof(*lexer));
+    lexer->text      = text;
+    lexer->text_size = text_size;
+    lexer->at_end    = true;
+}
+
+void lexer_create_stream(Lexer* lexer, LexerReadFunction read, void* read_user, size_t buffer_size) {
+    memset(lexer, 0, sizeof(*lexer));
+    lexer->buffer          = my_malloc(buffer_size);
+    lexer->buffer_capacity = buffer_size;
+    lexer->text            = lexer->buffer;
+    lexer->read            = read;
+    lexer->read_user       = read_user;
+}
+
+static size_t read_from_file(void* user, char* buffer, size_t size) {
+    return fread(buffer, 1, size, (FILE*) user);
+}
+
+void lexer_create_file(Lexer* lexer, FILE* file, size_t buffer_size) {
+    lexer_create_stream(lexer, read_from_file, file, buffer_size);
+}
+
+void lexer_delete(Lexer* lexer) {
+    my_free(lexer->buffer);
+    lexer->buffer = NULL;
+    lexer->text   = NULL;
+}
+
+// Drops what's no longer needed from the front of the buffer and reads more behind it. `keep` is a position in
+// `text` that has to survive on top of `keep_from`. Returns false if there was nothing more to read.
+static bool lexer_refill(Lexer* lexer, size_t keep) {
+    if (lexer->at_end) {
+        return false;
+    }
 
-    while (lexer.offset < lexer.text_size) {
-        Token token = parse_one(&lexer);
-        vector_push_back(&lexer.tokens, &token);
+    size_t drop = min(keep, lexer->keep_from - lexer->text_start);
+    memmove(lexer->buffer, lexer->buffer + drop, lexer->text_size - drop);
+    lexer->text_start += drop;
+    lexer->text_size -= drop;
+    lexer->offset -= drop;
+
+    if (lexer->text_size == lexer->buffer_capacity) {
+        size_t new_capacity = lexer->buffer_capacity * 2;
+        char* new_buffer    = my_malloc(new_capacity);
+        memcpy(new_buffer, lexer->buffer, lexer->text_size);
+        my_free(lexer->buffer);
+        lexer->buffer          = new_buffer;
+        lexer->buffer_capacity = new_capacity;
+        lexer->text            = new_buffer;
     }
 
-    return lexer.tokens;
+    char* read_into = lexer->buffer + lexer->text_size;
+    size_t read     = lexer->read(lexer->read_user, read_into, lexer->buffer_capacity - lexer->text_size);
+    if (read == 0) {
+        lexer->at_end = true;
+        return false;
+    }
+    lexer->text_size += read;
+    bail_out_if(lexer->text_start + lexer->text_size <= MAX_SOURCE_SIZE, "source file too big");
+    return true;
 }
 
-static const char* get_token_name(enum TokenType type) {
-    const char* names[TOKEN_END_SIZE];
-    for (size_t i = 0; i < array_size(names); ++i) {
-        names[i] = NULL;
+static void print_token(Writer* writer, size_t index, const char* text, Token token);
+
+bool lexer_next_token(Lexer* lexer, Token* token) {
+    while (true) {
+        if (lexer->offset == lexer->text_size && !lexer_refill(lexer, lexer->offset)) {
+            return false;
+        }
+
+        size_t start_offset = lexer->offset;
+        Token current       = parse_one(lexer);
+
+        // A token that runs into the end of the buffer might go on in the next chunk, so read more and lex it
+        // again.
+        if (lexer->offset == lexer->text_size && !lexer->at_end) {
+            lexer->offset = start_offset;
+            lexer_refill(lexer, start_offset);
+            continue;
+        }
+
+        bail_out_if(lexer->offset - start_offset <= MAX_TOKEN_SIZE, "token too big");
+        current.offset += (uint32) lexer->text_start;
+
+        if (current.type == TOKEN_SPACE) {
+            if (lexer->trivia) {
+                vector_push_back(lexer->trivia, &current);
+            }
+            continue;
+        }
+
+        if (lexer->token_dump) {
+            print_token(lexer->token_dump, lexer->tokens_size, lexer->text + start_offset, current);
+        }
+        lexer->tokens_size++;
+
+        *token = current;
+        return true;
     }
+}
 
-    names[TOKEN_IDENT]         = "ident";
-    names[TOKEN_INTEGER]       = "integer";
-    names[TOKEN_SPACE]         = "space";
-    names[TOKEN_OPEN_PAREN]    = "open_paren";
-    names[TOKEN_CLOSED_PAREN]  = "closed_paren";
-    names[TOKEN_OPEN_BRACE]    = "open_brace";
-    names[TOKEN_CLOSED_BRACE]  = "closed_brace";
-    names[TOKEN_COMMA]         = "comma";
-    names[TOKEN_COLON]         = "colon";
-    names[TOKEN_SEMI]          = "semi";
-    names[TOKEN_AMPERSAND]     = "ampersand";
-    names[TOKEN_STAR]          = "star";
-    names[TOKEN_EQUAL]         = "equal";
-    names[TOKEN_DOUBLE_EQUAL]  = "double_equal";
-    names[TOKEN_LESS]          = "less";
-    names[TOKEN_LESS_EQUAL]    = "less_equal";
-    names[TOKEN_GREATER]       = "greater";
-    names[TOKEN_GREATER_EQUAL] = "greater_equal";
-    names[TOKEN_FN]            = "fn";
-    names[TOKEN_PLUS]          = "plus";
-    names[TOKEN_PLUS_EQUAL]    = "plus_equal";
-    names[TOKEN_MINUS]         = "minus";
-    names[TOKEN_MINUS_EQUAL]   = "minus_equal";
-    names[TOKEN_STAR]          = "star";
-    names[TOKEN_STAR_EQUAL]    = "star_equal";
-    names[TOKEN_SLASH]         = "slash";
-    names[TOKEN_SLASH_EQUAL]   = "slash_equal";
-    names[TOKEN_LET]           = "let";
-    names[TOKEN_TRUE]          = "true";
-    names[TOKEN_FALSE]         = "false";
-    names[TOKEN_NOT]           = "not";
-    names[TOKEN_NOT_EQUAL]     = "not_equal";
-    names[TOKEN_ARROW]         = "arrow";
-    names[TOKEN_RETURN]        = "return";
-
-    bail_out_if(names[type] != NULL, "unknown token");
-
-    return names[type];
+const char* lexer_token_text(const Lexer* lexer, Token token) {
+    bail_out_if(token.offset >= lexer->text_start, "token text already released");
+    return lexer->text + (token.offset - lexer->text_start);
 }
 
-static void escape(const char* input, size_t input_size, char* output, size_t max_output) {
-    size_t m = min(input_size, max_output / 2 - 1);
-    for (size_t i = 0; i < m; ++i) {
-        char current = input[i];
+void lexer_release(Lexer* lexer, size_t source_offset) {
+    lexer->keep_from = max(lexer->keep_from, source_offset);
+}
+
+VectorToken parse_tokens(const char* text, size_t text_size, VectorToken* trivia) {
+    Lexer lexer;
+    lexer_create_text(&lexer, text, text_size);
+    lexer.trivia = trivia;
 
-        const char* add;
-        switch (current) {
+    VectorToken tokens = create_vector_Token();
+    Token token;
+    while (lexer_next_token(&lexer, &token)) {
+        vector_push_back(&tokens, &token);
+    }
+
+    return tokens;
+}
+
+static const char* const token_names[TOKEN_END_SIZE] = {
+    [TOKEN_IDENT] = "ident",
+    [TOKEN_INTEGER] = "integer",
+    [TOKEN_SPACE] = "space",
+    [TOKEN_OPEN_PAREN] = "open_paren",
+    [TOKEN_CLOSED_PAREN] = "closed_paren",
+    [TOKEN_OPEN_BRACE] = "open_brace",
+    [TOKEN_CLOSED_BRACE] = "closed_brace",
+    [TOKEN_COMMA] = "comma",
+    [TOKEN_COLON] = "colon",
+    [TOKEN_SEMI] = "semi",
+    [TOKEN_AMPERSAND] = "ampersand",
+    [TOKEN_NOT] = "not",
+    [TOKEN_EQUAL] = "equal",
+    [TOKEN_DOUBLE_EQUAL] = "double_equal",
+    [TOKEN_NOT_EQUAL] = "not_equal",
+    [TOKEN_LESS] = "less",
+    [TOKEN_LESS_EQUAL] = "less_equal",
+    [TOKEN_GREATER] = "greater",
+    [TOKEN_GREATER_EQUAL] = "greater_equal",
+    [TOKEN_PLUS] = "plus",
+    [TOKEN_PLUS_EQUAL] = "plus_equal",
+    [TOKEN_MINUS] = "minus",
+    [TOKEN_MINUS_EQUAL] = "minus_equal",
+    [TOKEN_STAR] = "star",
+    [TOKEN_STAR_EQUAL] = "star_equal",
+    [TOKEN_SLASH] = "slash",
+    [TOKEN_SLASH_EQUAL] = "slash_equal",
+    [TOKEN_FN] = "fn",
+    [TOKEN_LET] = "let",
+    [TOKEN_RETURN] = "return",
+    [TOKEN_ARROW] = "arrow",
+    [TOKEN_TRUE] = "true",
+    [TOKEN_FALSE] = "false",
+};
+
+static const char* get_token_name(TokenType type) {
+    bail_out_if(type < TOKEN_END_SIZE && token_names[type] != NULL, "unknown token");
+    return token_names[type];
+}
+
+static void write_escaped(Writer* writer, const char* text, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        switch (text[i]) {
         case '\n':
-            add = "\\n";
+            writer_write(writer, "\\n", 2);
             break;
         case '\r':
-            add = "\\r";
+            writer_write(writer, "\\r", 2);
             break;
         case '\t':
-            add = "\\t";
+            writer_write(writer, "\\t", 2);
             break;
         default:
-            add = NULL;
-        }
-
-        if (add) {
-            output[0] = add[0];
-            output[1] = add[1];
-            output += 2;
-        } else {
-            output[0] = current;
-            output++;
+            writer_char(writer, text[i]);
         }
     }
-    *output = '\0';
 }
 
-void print_tokens(const char* text, const Token* tokens, size_t size) {
-    char buffer[8 * 1024];
-    char escaped[4 * 1024];
-    for (size_t i = 0; i < size; ++i) {
-        const Token current = tokens[i];
-        escape(text + current.offset, current.size, escaped, sizeof(escaped));
-        sprintf(
-              buffer,
-              "%zu . %s[%zu-%zu] : %s\n",
-              i,
-              get_token_name(current.type),
-              current.offset,
-              current.offset + current.size,
-              escaped);
-
-        printf(buffer);
-    }
+// "<index> . <name>[<begin>-<end>] : <text>"
+static void print_token(Writer* writer, size_t index, const char* text, Token token) {
+    writer_uint(writer, index);
+    writer_write(writer, " . ", 3);
+    writer_string(writer, get_token_name(token.type));
+    writer_char(writer, '[');
+    writer_uint(writer, token.offset);
+    writer_char(writer, '-');
+    writer_uint(writer, (uint64) token.offset + token.size);
+    writer_write(writer, "] : ", 4);
+    write_escaped(writer, text, token.size);
+    writer_char(writer, '\n');
 }
 
-void remove_spaces(Token* tokens, size_t* size) {
-    size_t insert = 0;
-    for (size_t i = 0; i < *size; ++i) {
-        if (tokens[i].type != TOKEN_SPACE) {
-            tokens[insert++] = tokens[i];
-        }
+void print_tokens(Writer* writer, const char* text, const Token* tokens, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        print_token(writer, i, text + tokens[i].offset, tokens[i]);
     }
-    *size = insert;
 }
 
 Token empty_token() {
-    Token result = { .type = TOKEN_NOTHING, .offset = -1, .size = -1 };
+    Token result = { .type = TOKEN_NOTHING, .offset = UINT32_MAX, .size = MAX_TOKEN_SIZE };
     return result;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.h"
+#include "writer.h"
 
 typedef enum {
     TOKEN_NOTHING,
@@ -46,15 +47,62 @@ typedef enum {
     TOKEN_END_SIZE,
 } TokenType;
 
+// Tokens are packed into 8 bytes, so the source is limited to 4 GB and a single token to 16 MB. The lexer bails
+// out on anything bigger; such inputs have to be split into several files.
+enum { MAX_TOKEN_SIZE = (1 << 24) - 1 };
+
+#define MAX_SOURCE_SIZE ((size_t) UINT32_MAX)
+
 typedef struct {
-    TokenType type;
-    size_t offset;
-    size_t size;
+    uint32 offset;
+    uint32 size : 24;
+    uint32 type : 8;
 } Token;
 
 VECTOR_OF(Token, Token);
 
-VectorToken parse_tokens(const char* text, size_t text_size);
-void print_tokens(const char* text, const Token* tokens, size_t size);
-void remove_spaces(Token* tokens, size_t* size);
+typedef size_t (*LexerReadFunction)(void* user, char* buffer, size_t size);
+
+// A pull-based lexer. It either walks a text that's fully in memory, or a window over a stream that's refilled
+// through `read` as tokens are pulled. Token offsets are always relative to the start of the whole source.
+typedef struct Lexer {
+    const char* text;
+    size_t text_size;
+    size_t offset;
+    // Source offset of `text[0]`.
+    size_t text_start;
+    // Source offset of the oldest token the caller still needs the text of. Refilling never drops anything
+    // from here on.
+    size_t keep_from;
+    bool at_end;
+
+    char* buffer;
+    size_t buffer_capacity;
+    LexerReadFunction read;
+    void* read_user;
+
+    VectorToken* trivia;
+    // Every token is written here as it's produced, for --dump-tokens; NULL for a normal compile.
+    Writer* token_dump;
+    size_t tokens_size;
+} Lexer;
+
+enum { LEXER_BUFFER_SIZE = 64 * 1024 };
+
+void lexer_create_text(Lexer* lexer, const char* text, size_t text_size);
+void lexer_create_stream(Lexer* lexer, LexerReadFunction read, void* read_user, size_t buffer_size);
+void lexer_create_file(Lexer* lexer, FILE* file, size_t buffer_size);
+void lexer_delete(Lexer* lexer);
+
+// Returns false once the source is exhausted. Whitespace is skipped, or collected into `trivia` if set.
+bool lexer_next_token(Lexer* lexer, Token* token);
+// The text of a token returned by `lexer_next_token`, valid until `keep_from` moves past it.
+const char* lexer_token_text(const Lexer* lexer, Token token);
+// Lets the lexer drop the text of everything before `source_offset` the next time it refills.
+void lexer_release(Lexer* lexer, size_t source_offset);
+
+// Whitespace never makes it into the returned tokens. If `trivia` isn't NULL, it's collected there instead, in
+// source order, for tools that need to put the original text back together.
+VectorToken parse_tokens(const char* text, size_t text_size, VectorToken* trivia);
+void print_tokens(Writer* writer, const char* text, const Token* tokens, size_t size);
 Token empty_token();
\ No newline at end of file
@@ -1,49 +1,167 @@
 #include <stdio.h>
 #include <string.h>
 #include "common.h"
-#include "lexer.h"
-#include "parser.h"
 #include "ast.h"
 #include "codegen.h"
+#include "jit.h"
+#include "program.h"
 
-static const char* read_file(const char* path) {
-    FILE* file = fopen(path, "rb");
-    bail_out_if(file != NULL, "can't read file");
+typedef struct Options {
+    // Every file becomes part of the same output, in this order. They're moved to the front of argv, so parsing the
+    // options allocates nothing and allocation tracking can start right after.
+    const char** paths;
+    size_t paths_size;
+    CodeGenOptions codegen;
+    bool time_report;
+    // Where --time-report=FILE writes JSON. Without a file the table goes to stderr, followed by LLVM's pass
+    // timings; those are left off for JSON so the phase times stay comparable from run to run.
+    const char* time_report_path;
+    // Both go to stdout, tokens as they're lexed and the AST once it's typed, before folding.
+    bool dump_tokens;
+    bool dump_ast;
+} Options;
 
-    size_t file_size = 0;
-    uint8 buffer[16 * 1024];
-    while (true) {
-        size_t ret = fread(buffer, 1, sizeof(buffer), file);
-        if (ret == 0) {
-            break;
-        }
+// Accepts both "-jN" and "-j N".
+static const char* option_value(int argc, char** argv, int* i, size_t name_size) {
+    const char* arg = argv[*i];
+    if (arg[name_size] != '\0') {
+        return arg + name_size;
+    }
+    bail_out_if(*i + 1 < argc, "option needs a value");
+    return argv[++*i];
+}
 
-        file_size += ret;
+static uint32 parse_number_option(const char* value, const char* message) {
+    bail_out_if(*value >= '0' && *value <= '9', message);
+    return (uint32) strtoul(value, NULL, 10);
+}
+
+static EmitKind parse_emit_kind(const char* value) {
+    if (strcmp(value, "obj") == 0) {
+        return EMIT_OBJECT;
+    }
+    if (strcmp(value, "bc") == 0) {
+        return EMIT_BITCODE;
+    }
+    if (strcmp(value, "ir") == 0) {
+        return EMIT_IR;
     }
-    rewind(file);
+    bail_out("--emit must be obj, bc or ir");
+}
 
-    char* result = my_malloc(file_size + 1);
-    fread(result, 1, file_size, file);
-    result[file_size] = '\0';
+static void parse_options(Options* options, int argc, char** argv) {
+    options->paths                   = (const char**) argv;
+    options->paths_size              = 0;
+    options->codegen.jobs            = 1;
+    options->codegen.opt_level       = 0;
+    options->codegen.emit            = EMIT_OBJECT;
+    options->codegen.output_path     = NULL;
+    options->codegen.jit             = false;
+    options->codegen.cache_directory = NULL;
+    options->codegen.time_report     = NULL;
+    options->codegen.time_passes     = false;
+    options->time_report             = false;
+    options->time_report_path        = NULL;
+    options->dump_tokens             = false;
+    options->dump_ast                = false;
 
-    fclose(file);
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "-j", 2) == 0) {
+            options->codegen.jobs = parse_number_option(option_value(argc, argv, &i, 2), "-j needs a number");
+        } else if (strncmp(arg, "-O", 2) == 0) {
+            options->codegen.opt_level = parse_number_option(arg + 2, "-O needs a level");
+        } else if (strncmp(arg, "-o", 2) == 0) {
+            options->codegen.output_path = option_value(argc, argv, &i, 2);
+        } else if (strncmp(arg, "--cache=", 8) == 0) {
+            options->codegen.cache_directory = arg + 8;
+        } else if (strcmp(arg, "--time-report") == 0) {
+            options->time_report         = true;
+            options->codegen.time_passes = true;
+        } else if (strncmp(arg, "--time-report=", 14) == 0) {
+            options->time_report      = true;
+            options->time_report_path = arg + 14;
+        } else if (strcmp(arg, "--dump-tokens") == 0) {
+            options->dump_tokens = true;
+        } else if (strcmp(arg, "--dump-ast") == 0) {
+            options->dump_ast = true;
+        } else if (strcmp(arg, "--jit") == 0) {
+            bail_out_if(JIT_SUPPORTED, JIT_UNSUPPORTED_MESSAGE);
+            options->codegen.jit = true;
+        } else if (strncmp(arg, "--emit=", 7) == 0) {
+            options->codegen.emit = parse_emit_kind(arg + 7);
+        } else {
+            options->paths[options->paths_size++] = arg;
+        }
+    }
+    bail_out_if(
+          options->paths_size > 0,
+          "usage: jerry_lang_c [-j jobs] [-O0..-O3] [--emit=obj|bc|ir] [-o output] [--jit] [--cache=dir] "
+          "[--time-report[=file.json]] [--dump-tokens] [--dump-ast] file...");
+}
 
-    return result;
+static void write_time_report(const Options* options, const TimeReport* report) {
+    if (options->time_report_path == NULL) {
+        time_report_print(report, stderr);
+        return;
+    }
+    FILE* file = fopen(options->time_report_path, "w");
+    bail_out_if(file, "can't open the time report file");
+    time_report_write_json(report, options->paths, options->paths_size, file);
+    fclose(file);
 }
 
 int main(int argc, char** argv) {
-    const char* file_path     = argv[1];
-    const char* file          = read_file(file_path);
-    VectorToken vector_tokens = parse_tokens(file, strlen(file));
-    Token* tokens             = vector_tokens.ptr;
-    size_t tokens_size        = vector_tokens.size;
-    remove_spaces(tokens, &tokens_size);
-    print_tokens(file, tokens, tokens_size);
-
-    AstContext ast;
-    ast_context_create(&ast, file);
-    parse(&ast, tokens, tokens_size);
-
-    CodeGen* codegen = codegen_create(&ast);
-    codegen_run(codegen);
+    Options options;
+    parse_options(&options, argc, argv);
+
+    TimeReport report;
+    if (options.time_report) {
+        allocation_tracking_start();
+    }
+    time_report_create(&report);
+    if (options.time_report) {
+        options.codegen.time_report = &report;
+    }
+    TimeReport* time_report = options.codegen.time_report;
+
+    bool dumping = options.dump_tokens || options.dump_ast;
+    Writer dump;
+    if (dumping) {
+        writer_create(&dump, stdout, WRITER_BUFFER_SIZE);
+    }
+
+    // Lexing, parsing, type fixing and folding, file by file on -j threads.
+    time_report_phase(time_report, "front end");
+    Program program;
+    program_create(&program, options.paths, options.paths_size);
+    program_parse(
+          &program,
+          options.codegen.jobs,
+          options.dump_tokens ? &dump : NULL,
+          options.dump_ast ? &dump : NULL);
+    if (dumping) {
+        // Before anything the program prints under --jit.
+        writer_delete(&dump);
+    }
+
+    time_report_phase(time_report, "link");
+    program_link(&program);
+
+    time_report_phase(time_report, "codegen");
+    CodeGen* codegen = codegen_create(&program.ast, &options.codegen);
+    int exit_code    = codegen_run(codegen);
+
+    program_report_arenas(&program, time_report);
+    time_report_phase(time_report, "cleanup");
+    codegen_delete(codegen);
+    program_delete(&program);
+    time_report_finish(time_report);
+
+    if (options.time_report) {
+        write_time_report(&options, &report);
+    }
+    time_report_delete(&report);
+    codegen_shutdown();
+    return exit_code;
 }
\ No newline at end of file
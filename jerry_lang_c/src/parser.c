@@ -1,70 +1,118 @@
 #include <inttypes.h>
 #include "ast.h"
 #include "parser.h"
+#include "symbol_table.h"
 
+// Tokens are pulled from the lexer only as far as the parser looks ahead, which is never more than the current
+// token: every token is looked at once, in order. `window` holds the tokens from `window_start` on; the ones
+// before the current statement are dropped so their text can go too.
 typedef struct {
     AstContext* context;
-    const Token* tokens;
-    size_t tokens_size;
+    Lexer* lexer;
+    VectorToken window;
+    size_t window_start;
     size_t offset;
+
+    // Running hash of every token before `hashed`, see `FunctionItem::content_hash`.
+    uint64 content_hash;
+    size_t hashed;
 } Parser;
 
+static bool parser_has_token(Parser* parser, size_t index) {
+    while (index >= parser->window_start + parser->window.size) {
+        Token token;
+        if (!lexer_next_token(parser->lexer, &token)) {
+            return false;
+        }
+        vector_push_back(&parser->window, &token);
+    }
+    return true;
+}
+
+static Token parser_token(Parser* parser, size_t index) {
+    bail_out_if(parser_has_token(parser, index), "no more tokens:(");
+    return parser->window.ptr[index - parser->window_start];
+}
+
+static const char* parser_token_text(Parser* parser, Token token) {
+    return lexer_token_text(parser->lexer, token);
+}
+
+// Feeds the tokens consumed since the last call into `content_hash`, while their text is still around.
+static void parser_hash_consumed(Parser* parser) {
+    for (; parser->hashed < parser->offset; ++parser->hashed) {
+        Token token          = parser_token(parser, parser->hashed);
+        uint8 type           = (uint8) token.type;
+        uint32 size          = token.size;
+        parser->content_hash = hash64_update(parser->content_hash, &type, sizeof(type));
+        parser->content_hash = hash64_update(parser->content_hash, &size, sizeof(size));
+        parser->content_hash = hash64_update(parser->content_hash, parser_token_text(parser, token), size);
+    }
+}
+
+// Forgets every token before the current one. Only call this when nothing parsed so far refers to them.
+static void parser_release(Parser* parser) {
+    parser_hash_consumed(parser);
+
+    size_t drop = parser->offset - parser->window_start;
+    memmove(parser->window.ptr, parser->window.ptr + drop, (parser->window.size - drop) * sizeof(Token));
+    parser->window.size -= drop;
+    parser->window_start = parser->offset;
+
+    if (parser->window.size > 0) {
+        lexer_release(parser->lexer, parser->window.ptr[0].offset);
+    } else {
+        lexer_release(parser->lexer, parser->lexer->text_start + parser->lexer->offset);
+    }
+}
+
 #define expect_token(expected)                                                                                         \
-    bail_out_if(parser->offset < parser->tokens_size, "no more tokens:(");                                             \
-    bail_out_if(parser->tokens[parser->offset].type == expected, "unexpected token");
+    bail_out_if(parser_has_token(parser, parser->offset), "no more tokens:(");                                         \
+    bail_out_if(parser_token(parser, parser->offset).type == expected, "unexpected token");
 
 #define expect_token_eat(expected)                                                                                     \
     expect_token(expected);                                                                                            \
     parser->offset++;
 
-#define get_current_token() parser->tokens[parser->offset]
+#define get_current_token() parser_token(parser, parser->offset)
 
-#define get_current_token_eat() parser->tokens[parser->offset++]
+#define get_current_token_eat() parser_token(parser, parser->offset++)
 
 #define expect_get_eat(var, expected)                                                                                  \
     expect_token(expected);                                                                                            \
     var = get_current_token_eat();
 
-#define ast_alloc(type) (type*) ast_alloc_impl(parser->context, sizeof(type))
+#define ast_alloc(type) ast_alloc_in(parser->context, type)
 
-#define ast_alloc_array(type, size) (type*) ast_alloc_impl(parser->context, sizeof(type) * size)
+#define ast_alloc_array(type, size) ast_alloc_array_in(parser->context, type, size)
 
-static bool is_binary_token_operator(TokenType type) {
+static bool get_binary_operator(TokenType type, BinaryKind* kind) {
     switch (type) {
     case TOKEN_PLUS:
-    case TOKEN_MINUS:
-    case TOKEN_STAR:
-    case TOKEN_SLASH:
+        *kind = BINARY_PLUS;
         return true;
-    default:
-        return false;
-    }
-}
-
-static BinaryKind parse_binary_operator(TokenType type) {
-    switch (type) {
-    case TOKEN_PLUS:
-        return BINARY_PLUS;
     case TOKEN_MINUS:
-        return BINARY_MINUS;
+        *kind = BINARY_MINUS;
+        return true;
     case TOKEN_STAR:
-        return BINARY_MUL;
+        *kind = BINARY_MUL;
+        return true;
     case TOKEN_SLASH:
-        return BINARY_DIV;
+        *kind = BINARY_DIV;
+        return true;
 
     case TOKEN_DOUBLE_EQUAL:
-        return BINARY_EQ;
+        *kind = BINARY_EQ;
+        return true;
     case TOKEN_NOT_EQUAL:
-        return BINARY_NOT_EQ;
-
-    case TOKEN_AMPERSAND:
-        return UNARY_ADDRESS_OF;
+        *kind = BINARY_NOT_EQ;
+        return true;
     default:
-        abort();
+        return false;
     }
 }
 
-static Expr* parse_expression(Parser* parser, size_t end);
+static Expr* parse_expression(Parser* parser);
 static Expr* parse_one_expression(Parser* parser);
 
 static bool is_unary_token_operator(TokenType type) {
@@ -99,35 +147,35 @@ static Expr* parse_unary(Parser* parser) {
     return (Expr*) unary;
 }
 
-static size_t find_closed_brace(const Parser* parser, size_t start_at) {
-    for (size_t i = max(start_at, parser->offset); i < parser->tokens_size; ++i) {
-        const Token* current = parser->tokens + i;
-        if (current->type == TOKEN_OPEN_BRACE) {
-            i = find_closed_brace(parser, i);
-        } else if (current->type == TOKEN_CLOSED_PAREN) {
-            return i;
-        }
-    }
-    return -1;
+static bool is_digit(char ch) {
+    return '0' <= ch && ch <= '9';
 }
 
 static IntLitExpr* parse_integer_literal(Parser* parser) {
     Token token_number;
     expect_get_eat(token_number, TOKEN_INTEGER);
 
-    const char* original_text = parser->context->original_text + token_number.offset;
-    bool has_specifier        = false;
-    for (size_t i = 0; i < token_number.size && !has_specifier; ++i) {
-        char current  = original_text[i];
-        has_specifier = current == 'u' || current == 's';
+    // The token text isn't NUL terminated when it comes from a stream, so this can't go through sscanf.
+    const char* text = parser_token_text(parser, token_number);
+    size_t i         = 0;
+
+    uint64 the_number = 0;
+    for (; i < token_number.size && is_digit(text[i]); ++i) {
+        the_number = the_number * 10 + (uint64) (text[i] - '0');
     }
-    const char* format = has_specifier ? "%" PRIu64 "%c%" PRIu16 : "%" PRIu64;
 
-    uint64 the_number;
     char specifier      = 'u';
     uint16 integer_size = 64;
+    if (i < token_number.size) {
+        specifier = text[i++];
 
-    sscanf(parser->context->original_text + token_number.offset, format, &the_number, &specifier, &integer_size);
+        if (i < token_number.size) {
+            integer_size = 0;
+        }
+        for (; i < token_number.size; ++i) {
+            integer_size = (uint16) (integer_size * 10 + (text[i] - '0'));
+        }
+    }
 
     IntLitExpr* number   = ast_alloc(IntLitExpr);
     number->expr.kind    = EXPR_INT_LIT;
@@ -137,6 +185,10 @@ static IntLitExpr* parse_integer_literal(Parser* parser) {
     return number;
 }
 
+static Symbol intern_token(Parser* parser, Token token) {
+    return ast_intern(parser->context, parser_token_text(parser, token), token.size);
+}
+
 static Expr* parse_one_expression(Parser* parser) {
     Token token = get_current_token();
     if (token.type == TOKEN_INTEGER) {
@@ -146,7 +198,7 @@ static Expr* parse_one_expression(Parser* parser) {
         expect_token_eat(TOKEN_OPEN_PAREN);
         ParenExpr* paren     = ast_alloc(ParenExpr);
         paren->expr.kind     = EXPR_PAREN;
-        paren->subexpression = parse_expression(parser, find_closed_brace(parser, 0));
+        paren->subexpression = parse_expression(parser);
         expect_token_eat(TOKEN_CLOSED_PAREN);
         return (Expr*) paren;
     }
@@ -158,6 +210,7 @@ static Expr* parse_one_expression(Parser* parser) {
         VariableReferenceExpr* var = ast_alloc(VariableReferenceExpr);
         var->expr.kind             = EXPR_VAR;
         var->token_name            = token;
+        var->name                  = intern_token(parser, token);
         return (Expr*) var;
     }
     if (token.type == TOKEN_TRUE || token.type == TOKEN_FALSE) {
@@ -187,86 +240,41 @@ static uint8 get_op_priority(BinaryKind kind) {
     }
 }
 
-typedef struct ExprToken {
-    union {
-        Expr* expr;
-        BinaryKind binary;
-    };
-    bool is_expr;
-} ExprToken;
-
-static size_t find_lowest_precedence_op(const ExprToken* tokens, size_t size) {
-    size_t result  = -1;
-    uint8 priority = -1;
-    for (size_t i = 0; i < size; ++i) {
-        const ExprToken* current = tokens + i;
-        if (!current->is_expr && priority > get_op_priority(current->binary)) {
-            result   = i;
-            priority = get_op_priority(current->binary);
-        }
-    }
-    return result;
+// Returns the binary operator at the current token if it binds at least as tight as `min_priority`.
+static bool peek_binary_operator(Parser* parser, uint8 min_priority, BinaryKind* kind) {
+    return parser_has_token(parser, parser->offset) && get_binary_operator(get_current_token().type, kind) &&
+           get_op_priority(*kind) >= min_priority;
 }
 
-static BinaryExpr* parse_binary(Parser* parser, const ExprToken* tokens, size_t size) {
-    size_t middle     = find_lowest_precedence_op(tokens, size);
-    size_t left_size  = middle;
-    size_t right_size = size - middle - 1;
+// Precedence climbing: folds operators into `left` for as long as they bind at least as tight as
+// `min_priority`, and recurses only when a tighter operator follows. The recursion depth is bounded by the
+// number of priority levels, so this is linear in the length of the expression. The expression ends at the
+// first token that isn't a binary operator, so no scanning ahead for its end is needed.
+static Expr* parse_binary(Parser* parser, Expr* left, uint8 min_priority) {
+    BinaryKind kind;
+    while (peek_binary_operator(parser, min_priority, &kind)) {
+        parser->offset++;
+        uint8 priority = get_op_priority(kind);
+        Expr* right    = parse_one_expression(parser);
 
-    BinaryExpr* binary = ast_alloc(BinaryExpr);
-    binary->expr.kind  = EXPR_BINARY;
-    if (left_size == 1) {
-        binary->left = tokens[0].expr;
-    } else {
-        binary->left = (Expr*) parse_binary(parser, tokens, middle);
-    }
+        BinaryKind next;
+        while (peek_binary_operator(parser, priority + 1, &next)) {
+            right = parse_binary(parser, right, priority + 1);
+        }
 
-    if (right_size == 1) {
-        binary->right = tokens[middle + 1].expr;
-    } else {
-        binary->right = (Expr*) parse_binary(parser, tokens + middle + 1, size - middle - 1);
+        BinaryExpr* binary = ast_alloc(BinaryExpr);
+        binary->expr.kind  = EXPR_BINARY;
+        binary->left       = left;
+        binary->right      = right;
+        binary->kind       = kind;
+        left               = (Expr*) binary;
     }
-    binary->kind = tokens[middle].binary;
-
-    return binary;
+    return left;
 }
 
-static Expr* parse_expression(Parser* parser, size_t end) {
+static Expr* parse_expression(Parser* parser) {
     Expr* first = parse_one_expression(parser);
-    if (parser->offset == end) {
-        return first;
-    }
-
-    ExprToken expr_tokens[256];
-    size_t expr_tokens_size = 0;
-    zero_array(expr_tokens);
-
-    expr_tokens[expr_tokens_size].expr      = first;
-    expr_tokens[expr_tokens_size++].is_expr = true;
-
-    bool last_op = false;
-    while (parser->offset < end) {
-        ExprToken* current = expr_tokens + expr_tokens_size;
-        if (last_op) {
-            current->expr    = parse_one_expression(parser);
-            current->is_expr = true;
-        } else {
-            current->binary  = parse_binary_operator(get_current_token_eat().type);
-            current->is_expr = false;
-        }
-        expr_tokens_size++;
-        last_op = !last_op;
-    }
-    return (Expr*) parse_binary(parser, expr_tokens, expr_tokens_size);
-}
-
-static size_t find_semi(const Parser* parser) {
-    for (size_t i = parser->offset; i < parser->tokens_size; ++i) {
-        if (parser->tokens[i].type == TOKEN_SEMI) {
-            return i;
-        }
-    }
-    abort();
+    return parse_binary(parser, first, 0);
 }
 
 static VariableAssignment* parse_variable_assignment(Parser* parser, bool let) {
@@ -276,15 +284,16 @@ static VariableAssignment* parse_variable_assignment(Parser* parser, bool let) {
     Token name;
     expect_get_eat(name, TOKEN_IDENT);
     expect_token_eat(TOKEN_EQUAL);
-    Expr* init = parse_expression(parser, find_semi(parser));
+    Expr* init = parse_expression(parser);
     expect_token_eat(TOKEN_SEMI);
 
     VariableAssignment* assign = ast_alloc(VariableAssignment);
     assign->stmt.kind          = STMT_VAR_ASSIGN;
     assign->token_name         = name;
-    assign->name               = parser->context->original_text + name.offset;
-    assign->name_size          = name.size;
+    assign->name               = intern_token(parser, name);
     assign->init               = init;
+    assign->declaration        = NULL;
+    assign->slot               = 0;
     assign->is_decl            = let;
 
     return assign;
@@ -293,10 +302,9 @@ static VariableAssignment* parse_variable_assignment(Parser* parser, bool let) {
 static ReturnStmt* parse_return(Parser* parser) {
     expect_token_eat(TOKEN_RETURN);
 
-    Expr* subexpr     = NULL;
-    size_t semi_index = find_semi(parser);
-    if (semi_index != parser->offset) {
-        subexpr = parse_expression(parser, semi_index);
+    Expr* subexpr = NULL;
+    if (get_current_token().type != TOKEN_SEMI) {
+        subexpr = parse_expression(parser);
     }
     expect_token_eat(TOKEN_SEMI);
 
@@ -311,7 +319,7 @@ static Block* parse_block(Parser* parser) {
     expect_token_eat(TOKEN_OPEN_BRACE);
 
     VectorVoid vector = create_vector_Void();
-    while (parser->offset < parser->tokens_size) {
+    while (parser_has_token(parser, parser->offset)) {
         TokenType current_type = get_current_token().type;
         Stmt* stmt;
         if (current_type == TOKEN_LET) {
@@ -322,6 +330,7 @@ static Block* parse_block(Parser* parser) {
             abort();
         }
         vector_push_back(&vector, &stmt);
+        parser_release(parser);
         if (get_current_token().type == TOKEN_CLOSED_BRACE) {
             break;
         }
@@ -338,6 +347,9 @@ static Block* parse_block(Parser* parser) {
 }
 
 static FunctionItem* parse_function(Parser* parser) {
+    parser_hash_consumed(parser);
+    parser->content_hash = HASH64_SEED;
+
     expect_token_eat(TOKEN_FN);
     Token function_name;
     expect_get_eat(function_name, TOKEN_IDENT);
@@ -345,7 +357,7 @@ static FunctionItem* parse_function(Parser* parser) {
 
     FunctionArgument arguments[32];
     size_t arguments_size = 0;
-    while (parser->offset < parser->tokens_size) {
+    while (parser_has_token(parser, parser->offset)) {
         if (get_current_token().type == TOKEN_CLOSED_PAREN) {
             break;
         }
@@ -364,7 +376,6 @@ static FunctionItem* parse_function(Parser* parser) {
 
     expect_token_eat(TOKEN_CLOSED_PAREN);
 
-    Block* block      = NULL;
     Token return_type = empty_token();
 
     TokenType next_token = get_current_token().type;
@@ -374,23 +385,33 @@ static FunctionItem* parse_function(Parser* parser) {
 
         next_token = get_current_token().type;
     }
-    if (next_token == TOKEN_SEMI) {
-        expect_token_eat(TOKEN_SEMI);
-    } else {
-        block = parse_block(parser);
-    }
 
+    // Everything that needs token text is interned before the block, which releases the tokens behind it.
     FunctionItem* function        = ast_alloc(FunctionItem);
     function->base.kind           = ITEM_FUNCTION;
     function->token_function_name = function_name;
     function->token_return_type   = return_type;
-    function->name                = parser->context->original_text + function_name.offset;
-    function->name_size           = function_name.size;
+    function->name                = intern_token(parser, function_name);
+    function->return_type_name    = 0;
+    function->unit                = parser->context;
     function->arguments           = ast_alloc_array(FunctionArgument, arguments_size);
     function->arguments_size      = arguments_size;
-    function->block               = block;
+    function->block               = NULL;
+    function->locals_size         = 0;
     memcpy(function->arguments, arguments, arguments_size * sizeof(*arguments));
 
+    if (return_type.type != TOKEN_NOTHING) {
+        function->return_type_name = intern_token(parser, return_type);
+    }
+
+    if (next_token == TOKEN_SEMI) {
+        expect_token_eat(TOKEN_SEMI);
+    } else {
+        function->block = parse_block(parser);
+    }
+
+    parser_hash_consumed(parser);
+    function->content_hash = parser->content_hash;
     return function;
 }
 
@@ -405,12 +426,13 @@ static Item* do_parse(Parser* parser) {
 /* ----------------------------------------------------------------------------------------------------------------- */
 
 #undef ast_alloc
-#define ast_alloc(type) (type*) ast_alloc_impl(fixer->ast, sizeof(type))
+#define ast_alloc(type) ast_alloc_in(fixer->ast, type)
 
 typedef struct TypeFixer {
     AstContext* ast;
-    VariableAssignment* variables[32];
-    size_t variables_size;
+    SymbolTable variables;
+    // Locals declared so far in the current function.
+    uint32 locals_size;
 } TypeFixer;
 
 static void fix_types_expr(TypeFixer* fixer, Expr* expr);
@@ -445,12 +467,7 @@ static void fix_types_unary(TypeFixer* fixer, UnaryExpr* unary) {
 }
 
 static void fix_types_int_lit(TypeFixer* fixer, IntLitExpr* integer) {
-    PrimitiveType* type = ast_alloc(PrimitiveType);
-    type->base.kind     = TYPE_PRIMITIVE;
-    type->kind          = PRIMITIVE_NUMBER;
-    type->integer_size  = integer->integer_size;
-    type->is_unsigned   = integer->is_unsigned;
-    integer->expr.type  = (Type*) type;
+    integer->expr.type = ast_primitive_type(fixer->ast, PRIMITIVE_NUMBER, integer->integer_size, integer->is_unsigned);
 }
 
 static void fix_types_bool_lit(TypeFixer* fixer, BoolLitExpr* boolean) {
@@ -458,17 +475,11 @@ static void fix_types_bool_lit(TypeFixer* fixer, BoolLitExpr* boolean) {
 }
 
 static void fix_types_var_ref(TypeFixer* fixer, VariableReferenceExpr* var) {
-    const char* name = fixer->ast->original_text + var->token_name.offset;
-
-    for (size_t i = 0; i < fixer->variables_size; ++i) {
-        VariableAssignment* current = fixer->variables[fixer->variables_size - i - 1];
-        if (string_compare(current->name, current->name_size, name, var->token_name.size) == 0) {
-            var->declaration = current;
-            var->expr.type   = current->init->type;
-            return;
-        }
-    }
-    abort();
+    VariableAssignment* declaration = symbol_table_find(&fixer->variables, var->name);
+    bail_out_if(declaration, "unknown variable");
+
+    var->declaration = declaration;
+    var->expr.type   = declaration->init->type;
 }
 
 static void fix_types_expr(TypeFixer* fixer, Expr* expr) {
@@ -478,20 +489,25 @@ static void fix_types_expr(TypeFixer* fixer, Expr* expr) {
 static void fix_types_var_assign(TypeFixer* fixer, VariableAssignment* assign) {
     fix_types_expr(fixer, assign->init);
     if (assign->is_decl) {
-        bool name_already_exist = false;
-        for (size_t i = 0; i < fixer->variables_size && !name_already_exist; ++i) {
-            const VariableAssignment* current = fixer->variables[fixer->variables_size - i - 1];
-            name_already_exist =
-                  string_compare(current->name, current->name_size, assign->name, assign->name_size) == 0;
-        }
-        bail_out_if(!name_already_exist, "name already exists");
+        bool inserted = symbol_table_insert(&fixer->variables, assign->name, assign);
+        bail_out_if(inserted, "name already exists");
 
-        fixer->variables[fixer->variables_size++] = assign;
+        assign->declaration = assign;
+        assign->slot        = fixer->locals_size++;
+    } else {
+        VariableAssignment* declaration = symbol_table_find(&fixer->variables, assign->name);
+        bail_out_if(declaration, "unknown variable");
+        bail_out_if(types_equal(declaration->init->type, assign->init->type), "types not equal");
+
+        assign->declaration = declaration;
+        assign->slot        = declaration->slot;
     }
 }
 
 static void fix_types_return(TypeFixer* fixer, ReturnStmt* return_stmt) {
-    fix_types_expr(fixer, return_stmt->subexpr);
+    if (return_stmt->subexpr) {
+        fix_types_expr(fixer, return_stmt->subexpr);
+    }
 }
 
 static void fix_types_stmt(TypeFixer* fixer, Stmt* stmt) {
@@ -499,27 +515,20 @@ static void fix_types_stmt(TypeFixer* fixer, Stmt* stmt) {
 }
 
 static void fix_types_block(TypeFixer* fixer, Block* block) {
-    size_t variables_size_original = fixer->variables_size;
+    symbol_table_push_scope(&fixer->variables);
 
     for (size_t i = 0; i < block->stmts_size; ++i) {
         fix_types_stmt(fixer, block->stmts[i]);
     }
 
-    fixer->variables_size = variables_size_original;
+    symbol_table_pop_scope(&fixer->variables);
 }
 
-static Type* fix_types_type(TypeFixer* fixer, Token token) {
-    make_string_stack(token_text, 256, fixer->ast->original_text + token.offset, token.size);
+static Type* fix_types_type(TypeFixer* fixer, Symbol name) {
+    const char* token_text = ast_symbol_string(fixer->ast, name);
     if (token_text[0] == 'u' || token_text[0] == 's') {
         long number = atol(token_text + 1);
-
-        PrimitiveType* type = ast_alloc(PrimitiveType);
-        type->base.kind     = TYPE_PRIMITIVE;
-        type->kind          = PRIMITIVE_NUMBER;
-        type->integer_size  = (uint16) number;
-        type->is_unsigned   = token_text[0] == 'u';
-
-        return (Type*) type;
+        return ast_primitive_type(fixer->ast, PRIMITIVE_NUMBER, (uint16) number, token_text[0] == 'u');
     }
 
     abort();
@@ -529,9 +538,12 @@ static void fix_types_function(TypeFixer* fixer, FunctionItem* function) {
     if (function->token_return_type.type == TOKEN_NOTHING) {
         function->return_type = fixer->ast->type_void;
     } else {
-        function->return_type = fix_types_type(fixer, function->token_return_type);
+        function->return_type = fix_types_type(fixer, function->return_type_name);
     }
+
+    fixer->locals_size = 0;
     fix_types_block(fixer, function->block);
+    function->locals_size = fixer->locals_size;
 }
 
 static void fix_types_item(TypeFixer* fixer, Item* item) {
@@ -544,15 +556,17 @@ static void fix_types(TypeFixer* fixer) {
     }
 }
 
-void parse(AstContext* ast, const Token* tokens, size_t size) {
-    Parser parser_owned = { .context = ast, .tokens = tokens, .tokens_size = size, .offset = 0 };
+void parse(AstContext* ast, Lexer* lexer) {
+    Parser parser_owned = { .context = ast, .lexer = lexer, .window = create_vector_Token(), .offset = 0 };
     Parser* parser      = &parser_owned;
 
     VectorItemPtr items = create_vector_ItemPtr();
-    while (parser->offset < parser->tokens_size) {
+    while (parser_has_token(parser, parser->offset)) {
         Item* item = do_parse(parser);
         vector_push_back(&items, &item);
+        parser_release(parser);
     }
+    delete_vector(&parser->window);
 
     ast->items      = ast_alloc_array(Item*, items.size);
     ast->items_size = items.size;
@@ -562,6 +576,8 @@ void parse(AstContext* ast, const Token* tokens, size_t size) {
     memcpy(ast->items, items.ptr, items.element_size * items.size);
     delete_vector(&items);
 
-    TypeFixer fixer = { .ast = ast, .variables_size = 0 };
+    TypeFixer fixer = { .ast = ast, .locals_size = 0 };
+    symbol_table_create(&fixer.variables);
     fix_types(&fixer);
+    symbol_table_delete(&fixer.variables);
 }
\ No newline at end of file
@@ -4,4 +4,6 @@
 #include "common.h"
 #include "lexer.h"
 
-void parse(AstContext* context, const Token* tokens, size_t size);
\ No newline at end of file
+// Pulls tokens from `lexer` as it goes. The AST keeps its own copies of any text it needs, so the source can be
+// streamed.
+void parse(AstContext* context, Lexer* lexer);
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "program.h"
+#include "fold.h"
+#include "input.h"
+#include "parser.h"
+#include "scan.h"
+#include "thread.h"
+
+void program_create(Program* program, const char* const* paths, size_t paths_size) {
+    program->units      = my_malloc(paths_size * sizeof(SourceUnit));
+    program->units_size = paths_size;
+    for (size_t i = 0; i < paths_size; ++i) {
+        SourceUnit* unit = program->units + i;
+        unit->path       = paths[i];
+        ast_context_create(&unit->ast);
+        unit->ast.path = unit->path;
+    }
+
+    ast_context_create(&program->ast);
+    symbol_table_create(&program->functions);
+}
+
+void program_delete(Program* program) {
+    for (size_t i = 0; i < program->units_size; ++i) {
+        ast_context_delete(&program->units[i].ast);
+    }
+    my_free(program->units);
+    program->units = NULL;
+
+    ast_context_delete(&program->ast);
+    symbol_table_delete(&program->functions);
+}
+
+static void parse_unit(SourceUnit* unit, Writer* token_writer, Writer* ast_writer) {
+    SourceFile source;
+    source_file_open(&source, unit->path);
+
+    Lexer lexer;
+    source_file_create_lexer(&source, &lexer);
+    lexer.token_dump = token_writer;
+
+    parse(&unit->ast, &lexer);
+    lexer_delete(&lexer);
+    source_file_close(&source);
+
+    if (ast_writer) {
+        ast_dump(&unit->ast, ast_writer);
+    }
+    fold_constants(&unit->ast);
+}
+
+typedef struct FrontEnd {
+    Program* program;
+    // Index of the next unit nobody has taken yet. Files differ a lot in size, so workers take one at a time
+    // instead of splitting the list up front.
+    uint64 next_unit;
+} FrontEnd;
+
+static void run_front_end_worker(void* argument) {
+    FrontEnd* front_end = argument;
+    Program* program    = front_end->program;
+    for (;;) {
+        uint64 index = atomic_add_u64(&front_end->next_unit, 1);
+        if (index >= program->units_size) {
+            return;
+        }
+        parse_unit(program->units + index, NULL, NULL);
+    }
+}
+
+void program_parse(Program* program, uint32 jobs, Writer* token_writer, Writer* ast_writer) {
+    size_t threads = jobs == 0 ? hardware_thread_count() : jobs;
+    threads        = min(threads, program->units_size);
+    if (threads <= 1 || token_writer || ast_writer) {
+        for (size_t i = 0; i < program->units_size; ++i) {
+            parse_unit(program->units + i, token_writer, ast_writer);
+        }
+        return;
+    }
+
+    scan_init();
+    FrontEnd front_end = { .program = program, .next_unit = 0 };
+    Thread* workers    = my_malloc(threads * sizeof(Thread));
+    for (size_t i = 0; i < threads; ++i) {
+        thread_start(workers + i, run_front_end_worker, &front_end);
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        thread_join(workers + i);
+    }
+    my_free(workers);
+}
+
+static void link_function(Program* program, FunctionItem* function) {
+    const char* name = ast_symbol_string(function->unit, function->name);
+    size_t name_size = interner_string_size(&function->unit->interner, function->name);
+    function->name   = ast_intern(&program->ast, name, name_size);
+
+    const FunctionItem* existing = symbol_table_find(&program->functions, function->name);
+    if (existing) {
+        fprintf(stderr, "%s: `%s` is already defined in %s\n", function->unit->path, name, existing->unit->path);
+        bail_out("function defined twice");
+    }
+    symbol_table_insert(&program->functions, function->name, function);
+}
+
+static void link_item(Program* program, Item* item) {
+    ITERATE_ITEMS(ITERATE_DEFAULT_RETURN_VOID, item, link, program);
+}
+
+void program_link(Program* program) {
+    size_t items_size = 0;
+    for (size_t i = 0; i < program->units_size; ++i) {
+        items_size += program->units[i].ast.items_size;
+    }
+    program->ast.items      = ast_alloc_array_in(&program->ast, Item*, items_size);
+    program->ast.items_size = items_size;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < program->units_size; ++i) {
+        const AstContext* unit_ast = &program->units[i].ast;
+        for (size_t j = 0; j < unit_ast->items_size; ++j) {
+            link_item(program, unit_ast->items[j]);
+            program->ast.items[offset++] = unit_ast->items[j];
+        }
+    }
+}
+
+void program_report_arenas(const Program* program, TimeReport* report) {
+    for (size_t i = 0; i < program->units_size; ++i) {
+        time_report_arena(report, "file ast", &program->units[i].ast.arena);
+    }
+    time_report_arena(report, "program ast", &program->ast.arena);
+}
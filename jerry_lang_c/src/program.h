@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ast.h"
+#include "symbol_table.h"
+#include "time_report.h"
+#include "writer.h"
+
+typedef struct SourceUnit {
+    const char* path;
+    AstContext ast;
+} SourceUnit;
+
+// Source files compiled together. Every file gets its own AstContext, arena and interner included, so files are
+// lexed, parsed, type fixed and folded on different threads without sharing or locking anything. Linking then
+// ties them together in `ast`, which is what codegen works on.
+typedef struct Program {
+    SourceUnit* units;
+    size_t units_size;
+
+    // Every file's items in command-line order, with function names interned here.
+    AstContext ast;
+    // Every function in the program, by its name in `ast`.
+    SymbolTable functions;
+} Program;
+
+void program_create(Program* program, const char* const* paths, size_t paths_size);
+void program_delete(Program* program);
+
+// Runs the front end on every file, on up to `jobs` threads; 0 uses one per hardware thread. Dumps, when not
+// NULL, are written in file order, so asking for one parses the files one at a time.
+void program_parse(Program* program, uint32 jobs, Writer* token_writer, Writer* ast_writer);
+
+// Gives every function its program-wide name and bails out if two functions share one.
+void program_link(Program* program);
+
+// Adds every AST arena to `report`, the files' together in one row and the program's in another.
+void program_report_arenas(const Program* program, TimeReport* report);
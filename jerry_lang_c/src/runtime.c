@@ -0,0 +1,9 @@
+#include "runtime.h"
+
+void println_string(const char* string) {
+    printf("%s\n", string);
+}
+
+void println_number(int64_t number) {
+    printf("%lld\n", (long long) number);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "common.h"
+
+// Functions Jerry programs can call. They're compiled into the compiler so that --jit can hand them to the
+// program directly; ahead of time builds get them from working/std.cpp instead.
+void println_string(const char* string);
+void println_number(int64_t number);
@@ -0,0 +1,240 @@
+#include "scan.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#    define SCAN_HAS_X64 1
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#        define TARGET_AVX2
+#    else
+#        define TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#else
+#    define SCAN_HAS_X64 0
+#endif
+
+static bool scalar_is_space(char ch) {
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+static bool scalar_is_ident(char ch) {
+    char lower = ch | 0x20;
+    return ('a' <= lower && lower <= 'z') || ('0' <= ch && ch <= '9') || ch == '_';
+}
+
+static size_t scan_space_scalar(const char* text, size_t offset, size_t size) {
+    while (offset < size && scalar_is_space(text[offset])) {
+        ++offset;
+    }
+    return offset;
+}
+
+static size_t scan_ident_scalar(const char* text, size_t offset, size_t size) {
+    while (offset < size && scalar_is_ident(text[offset])) {
+        ++offset;
+    }
+    return offset;
+}
+
+#if SCAN_HAS_X64
+
+// Most whitespace runs are a single space and most identifiers are short, so the vector kernels look at the
+// first few bytes one at a time before paying for a full load.
+enum { SCALAR_PREFIX = 8 };
+
+static uint32_t count_trailing_zeros(uint32_t value) {
+#    ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#    else
+    return __builtin_ctz(value);
+#    endif
+}
+
+// Bytes are compared as signed, so anything >= 0x80 falls outside every range and ends the run.
+static __m128i sse2_in_range(__m128i chunk, char low, char high) {
+    __m128i above_low  = _mm_cmpgt_epi8(chunk, _mm_set1_epi8(low - 1));
+    __m128i below_high = _mm_cmplt_epi8(chunk, _mm_set1_epi8(high + 1));
+    return _mm_and_si128(above_low, below_high);
+}
+
+static __m128i sse2_space_mask(__m128i chunk) {
+    __m128i space = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '));
+    __m128i nl    = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
+    __m128i cr    = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'));
+    __m128i tab   = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'));
+    return _mm_or_si128(_mm_or_si128(space, nl), _mm_or_si128(cr, tab));
+}
+
+static __m128i sse2_ident_mask(__m128i chunk) {
+    __m128i lower      = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    __m128i letter     = sse2_in_range(lower, 'a', 'z');
+    __m128i digit      = sse2_in_range(chunk, '0', '9');
+    __m128i underscore = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(letter, digit), underscore);
+}
+
+static size_t scan_space_sse2(const char* text, size_t offset, size_t size) {
+    size_t prefix_end = min(offset + SCALAR_PREFIX, size);
+    for (; offset < prefix_end; ++offset) {
+        if (!scalar_is_space(text[offset])) {
+            return offset;
+        }
+    }
+    for (; offset + 16 <= size; offset += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) (text + offset));
+        uint32_t stop = ~(uint32_t) _mm_movemask_epi8(sse2_space_mask(chunk)) & 0xFFFF;
+        if (stop) {
+            return offset + count_trailing_zeros(stop);
+        }
+    }
+    return scan_space_scalar(text, offset, size);
+}
+
+static size_t scan_ident_sse2(const char* text, size_t offset, size_t size) {
+    size_t prefix_end = min(offset + SCALAR_PREFIX, size);
+    for (; offset < prefix_end; ++offset) {
+        if (!scalar_is_ident(text[offset])) {
+            return offset;
+        }
+    }
+    for (; offset + 16 <= size; offset += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) (text + offset));
+        uint32_t stop = ~(uint32_t) _mm_movemask_epi8(sse2_ident_mask(chunk)) & 0xFFFF;
+        if (stop) {
+            return offset + count_trailing_zeros(stop);
+        }
+    }
+    return scan_ident_scalar(text, offset, size);
+}
+
+TARGET_AVX2 static __m256i avx2_in_range(__m256i chunk, char low, char high) {
+    __m256i above_low  = _mm256_cmpgt_epi8(chunk, _mm256_set1_epi8(low - 1));
+    __m256i below_high = _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), chunk);
+    return _mm256_and_si256(above_low, below_high);
+}
+
+TARGET_AVX2 static size_t scan_space_avx2(const char* text, size_t offset, size_t size) {
+    size_t prefix_end = min(offset + SCALAR_PREFIX, size);
+    for (; offset < prefix_end; ++offset) {
+        if (!scalar_is_space(text[offset])) {
+            return offset;
+        }
+    }
+    for (; offset + 32 <= size; offset += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*) (text + offset));
+        __m256i space = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' '));
+        __m256i nl    = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+        __m256i cr    = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'));
+        __m256i tab   = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'));
+        __m256i mask  = _mm256_or_si256(_mm256_or_si256(space, nl), _mm256_or_si256(cr, tab));
+        uint32_t stop = ~(uint32_t) _mm256_movemask_epi8(mask);
+        if (stop) {
+            return offset + count_trailing_zeros(stop);
+        }
+    }
+    return scan_space_sse2(text, offset, size);
+}
+
+TARGET_AVX2 static size_t scan_ident_avx2(const char* text, size_t offset, size_t size) {
+    size_t prefix_end = min(offset + SCALAR_PREFIX, size);
+    for (; offset < prefix_end; ++offset) {
+        if (!scalar_is_ident(text[offset])) {
+            return offset;
+        }
+    }
+    for (; offset + 32 <= size; offset += 32) {
+        __m256i chunk      = _mm256_loadu_si256((const __m256i*) (text + offset));
+        __m256i lower      = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+        __m256i letter     = avx2_in_range(lower, 'a', 'z');
+        __m256i digit      = avx2_in_range(chunk, '0', '9');
+        __m256i underscore = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_'));
+        __m256i mask       = _mm256_or_si256(_mm256_or_si256(letter, digit), underscore);
+        uint32_t stop      = ~(uint32_t) _mm256_movemask_epi8(mask);
+        if (stop) {
+            return offset + count_trailing_zeros(stop);
+        }
+    }
+    return scan_ident_sse2(text, offset, size);
+}
+
+static bool cpu_has_avx2() {
+#    ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    bool has_avx     = (info[2] & (1 << 28)) != 0;
+    if (!has_osxsave || !has_avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#    else
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+
+#endif
+
+typedef size_t (*ScanFunction)(const char* text, size_t offset, size_t size);
+
+typedef struct ScanKernelData {
+    const char* name;
+    ScanFunction space;
+    ScanFunction ident;
+} ScanKernelData;
+
+static const ScanKernelData kernels[SCAN_KERNEL_SIZE] = {
+    [SCAN_SCALAR] = { .name = "scalar", .space = scan_space_scalar, .ident = scan_ident_scalar },
+#if SCAN_HAS_X64
+    [SCAN_SSE2] = { .name = "sse2", .space = scan_space_sse2, .ident = scan_ident_sse2 },
+    [SCAN_AVX2] = { .name = "avx2", .space = scan_space_avx2, .ident = scan_ident_avx2 },
+#else
+    [SCAN_SSE2] = { .name = "sse2" },
+    [SCAN_AVX2] = { .name = "avx2" },
+#endif
+};
+
+static const ScanKernelData* current_kernel = NULL;
+
+ScanKernel scan_best_kernel() {
+#if SCAN_HAS_X64
+    return cpu_has_avx2() ? SCAN_AVX2 : SCAN_SSE2;
+#else
+    return SCAN_SCALAR;
+#endif
+}
+
+void scan_set_kernel(ScanKernel kernel) {
+    bail_out_if(kernel < SCAN_KERNEL_SIZE && kernels[kernel].space != NULL, "scan kernel not supported");
+    bail_out_if(kernel != SCAN_AVX2 || scan_best_kernel() == SCAN_AVX2, "cpu doesn't support avx2");
+    current_kernel = kernels + kernel;
+}
+
+const char* scan_kernel_name(ScanKernel kernel) {
+    return kernels[kernel].name;
+}
+
+void scan_init() {
+    if (current_kernel == NULL) {
+        current_kernel = kernels + scan_best_kernel();
+    }
+}
+
+static const ScanKernelData* get_kernel() {
+    scan_init();
+    return current_kernel;
+}
+
+size_t scan_space(const char* text, size_t offset, size_t size) {
+    return get_kernel()->space(text, offset, size);
+}
+
+size_t scan_ident(const char* text, size_t offset, size_t size) {
+    return get_kernel()->ident(text, offset, size);
+}
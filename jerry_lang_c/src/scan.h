@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common.h"
+
+// Returns the offset of the first byte in [offset, size) that is not whitespace, or `size`.
+size_t scan_space(const char* text, size_t offset, size_t size);
+// Returns the offset of the first byte in [offset, size) that can't be part of an identifier, or `size`.
+size_t scan_ident(const char* text, size_t offset, size_t size);
+
+typedef enum ScanKernel {
+    SCAN_SCALAR,
+    SCAN_SSE2,
+    SCAN_AVX2,
+    SCAN_KERNEL_SIZE,
+} ScanKernel;
+
+// The kernel picked for this CPU on first use.
+ScanKernel scan_best_kernel();
+// Forces a specific kernel; used by the benchmarks. Bails out if the CPU can't run it.
+void scan_set_kernel(ScanKernel kernel);
+// Picks the best kernel unless one was set already. Scanning does this on first use, which is a race when several
+// threads lex at once, so they have to call it before they start.
+void scan_init();
+const char* scan_kernel_name(ScanKernel kernel);
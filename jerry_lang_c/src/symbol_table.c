@@ -0,0 +1,60 @@
+#include "symbol_table.h"
+
+enum { SYMBOL_TABLE_INITIAL_CAPACITY = 64 };
+
+void symbol_table_create(SymbolTable* table) {
+    table->capacity     = SYMBOL_TABLE_INITIAL_CAPACITY;
+    table->values       = my_malloc(table->capacity * sizeof(void*));
+    table->declared     = create_vector_Symbol();
+    table->scope_starts = create_vector_Size();
+    memset(table->values, 0, table->capacity * sizeof(void*));
+}
+
+void symbol_table_delete(SymbolTable* table) {
+    my_free(table->values);
+    table->values = NULL;
+    delete_vector(&table->declared);
+    delete_vector(&table->scope_starts);
+}
+
+static void grow(SymbolTable* table, Symbol name) {
+    size_t old_capacity = table->capacity;
+    while (name >= table->capacity) {
+        table->capacity *= 2;
+    }
+    table->values = my_realloc(table->values, table->capacity * sizeof(void*));
+    memset(table->values + old_capacity, 0, (table->capacity - old_capacity) * sizeof(void*));
+}
+
+void symbol_table_push_scope(SymbolTable* table) {
+    size_t start = table->declared.size;
+    vector_push_back(&table->scope_starts, &start);
+}
+
+void symbol_table_pop_scope(SymbolTable* table) {
+    bail_out_if(table->scope_starts.size > 0, "no scope to pop");
+    size_t start = table->scope_starts.ptr[--table->scope_starts.size];
+
+    for (size_t i = start; i < table->declared.size; ++i) {
+        table->values[table->declared.ptr[i]] = NULL;
+    }
+    table->declared.size = start;
+}
+
+bool symbol_table_insert(SymbolTable* table, Symbol name, void* value) {
+    bail_out_if(value != NULL, "symbols need a value");
+
+    if (name >= table->capacity) {
+        grow(table, name);
+    }
+    if (table->values[name]) {
+        return false;
+    }
+    table->values[name] = value;
+    vector_push_back(&table->declared, &name);
+    return true;
+}
+
+void* symbol_table_find(const SymbolTable* table, Symbol name) {
+    return name < table->capacity ? table->values[name] : NULL;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "interner.h"
+
+VECTOR_OF(Symbol, Symbol);
+VECTOR_OF(size_t, Size);
+
+// Maps symbols to values across nested scopes. Symbols are dense, so the table is a plain array indexed by them;
+// popping a scope costs one store per symbol it declared.
+typedef struct SymbolTable {
+    // NULL for symbols that aren't visible.
+    void** values;
+    size_t capacity;
+
+    VectorSymbol declared;
+    VectorSize scope_starts;
+} SymbolTable;
+
+void symbol_table_create(SymbolTable* table);
+void symbol_table_delete(SymbolTable* table);
+
+void symbol_table_push_scope(SymbolTable* table);
+void symbol_table_pop_scope(SymbolTable* table);
+
+// Returns false, without inserting anything, if `name` is already visible.
+bool symbol_table_insert(SymbolTable* table, Symbol name, void* value);
+void* symbol_table_find(const SymbolTable* table, Symbol name);
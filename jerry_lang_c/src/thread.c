@@ -0,0 +1,60 @@
+#include "thread.h"
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+static DWORD WINAPI thread_entry(LPVOID argument) {
+    Thread* thread = argument;
+    thread->function(thread->argument);
+    return 0;
+}
+
+void thread_start(Thread* thread, ThreadFunction function, void* argument) {
+    thread->function = function;
+    thread->argument = argument;
+    thread->handle   = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+    bail_out_if(thread->handle, "can't create thread");
+}
+
+void thread_join(Thread* thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    thread->handle = NULL;
+}
+
+uint32 hardware_thread_count() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+}
+
+#else
+
+static void* thread_entry(void* argument) {
+    Thread* thread = argument;
+    thread->function(thread->argument);
+    return NULL;
+}
+
+void thread_start(Thread* thread, ThreadFunction function, void* argument) {
+    thread->function = function;
+    thread->argument = argument;
+    bail_out_if(pthread_create(&thread->handle, NULL, thread_entry, thread) == 0, "can't create thread");
+}
+
+void thread_join(Thread* thread) {
+    pthread_join(thread->handle, NULL);
+}
+
+uint32 hardware_thread_count() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32) count : 1;
+}
+
+#endif
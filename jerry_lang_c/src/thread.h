@@ -0,0 +1,26 @@
+#pragma once
+
+#include "common.h"
+
+#ifndef _WIN32
+#    include <pthread.h>
+#endif
+
+typedef void (*ThreadFunction)(void* argument);
+
+typedef struct Thread {
+    ThreadFunction function;
+    void* argument;
+
+#ifdef _WIN32
+    void* handle;
+#else
+    pthread_t handle;
+#endif
+} Thread;
+
+// `thread` has to stay alive until it's joined.
+void thread_start(Thread* thread, ThreadFunction function, void* argument);
+void thread_join(Thread* thread);
+
+uint32 hardware_thread_count();
@@ -0,0 +1,267 @@
+#include "time_report.h"
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#    include <psapi.h>
+#else
+#    include <sys/resource.h>
+#endif
+
+#ifdef _WIN32
+
+static uint64 filetime_to_ns(FILETIME time) {
+    ULARGE_INTEGER value;
+    value.LowPart  = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return value.QuadPart * 100;
+}
+
+static void process_usage(ResourceUsage* usage) {
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    usage->cpu_ns = filetime_to_ns(kernel) + filetime_to_ns(user);
+
+    PROCESS_MEMORY_COUNTERS memory;
+    K32GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory));
+    usage->peak_rss_bytes = memory.PeakWorkingSetSize;
+}
+
+#else
+
+static uint64 timeval_to_ns(struct timeval time) {
+    return (uint64) time.tv_sec * 1000000000 + (uint64) time.tv_usec * 1000;
+}
+
+static void process_usage(ResourceUsage* usage) {
+    struct rusage rusage;
+    getrusage(RUSAGE_SELF, &rusage);
+    usage->cpu_ns = timeval_to_ns(rusage.ru_utime) + timeval_to_ns(rusage.ru_stime);
+#    ifdef __APPLE__
+    usage->peak_rss_bytes = (uint64) rusage.ru_maxrss;
+#    else
+    usage->peak_rss_bytes = (uint64) rusage.ru_maxrss * 1024;
+#    endif
+}
+
+#endif
+
+void resource_usage_now(ResourceUsage* usage) {
+    usage->wall_ns = time_now_ns();
+    process_usage(usage);
+
+    AllocationStats stats;
+    allocation_stats(&stats);
+    usage->allocations     = stats.count;
+    usage->allocated_bytes = stats.bytes;
+    usage->peak_live_bytes = stats.peak_live_bytes;
+}
+
+void time_report_create(TimeReport* report) {
+    report->phases   = create_vector_Phase();
+    report->in_phase = false;
+    report->arenas   = create_vector_ArenaUsage();
+}
+
+void time_report_delete(TimeReport* report) {
+    delete_vector(&report->phases);
+    delete_vector(&report->arenas);
+}
+
+void time_report_finish(TimeReport* report) {
+    if (report == NULL || !report->in_phase) {
+        return;
+    }
+    resource_usage_now(&report->phases.ptr[report->phases.size - 1].end);
+    report->in_phase = false;
+}
+
+void time_report_phase(TimeReport* report, const char* name) {
+    if (report == NULL) {
+        return;
+    }
+    time_report_finish(report);
+
+    Phase phase;
+    memset(&phase, 0, sizeof(phase));
+    phase.name = name;
+    allocation_reset_peak();
+    resource_usage_now(&phase.start);
+    vector_push_back(&report->phases, &phase);
+    report->in_phase = true;
+}
+
+void time_report_arena(TimeReport* report, const char* name, const Arena* arena) {
+    if (report == NULL) {
+        return;
+    }
+    ArenaUsage* usage = NULL;
+    for (size_t i = 0; i < report->arenas.size; ++i) {
+        if (strcmp(report->arenas.ptr[i].name, name) == 0) {
+            usage = report->arenas.ptr + i;
+            break;
+        }
+    }
+    if (usage == NULL) {
+        ArenaUsage empty;
+        memset(&empty, 0, sizeof(empty));
+        empty.name       = name;
+        empty.chunk_size = arena->chunk_size;
+        vector_push_back(&report->arenas, &empty);
+        usage = report->arenas.ptr + report->arenas.size - 1;
+    }
+    usage->arenas++;
+    usage->chunks += arena->chunks_used;
+    usage->bytes_used += arena->bytes_used;
+    usage->bytes_reserved += arena->bytes_reserved;
+}
+
+// What happened between `start` and `end`; the peaks are the ones reached by `end`.
+static ResourceUsage usage_between(const ResourceUsage* start, const ResourceUsage* end) {
+    ResourceUsage usage;
+    usage.wall_ns         = end->wall_ns - start->wall_ns;
+    usage.cpu_ns          = end->cpu_ns - start->cpu_ns;
+    usage.allocations     = end->allocations - start->allocations;
+    usage.allocated_bytes = end->allocated_bytes - start->allocated_bytes;
+    usage.peak_live_bytes = end->peak_live_bytes;
+    usage.peak_rss_bytes  = end->peak_rss_bytes;
+    return usage;
+}
+
+static ResourceUsage total_usage(const TimeReport* report) {
+    ResourceUsage total;
+    memset(&total, 0, sizeof(total));
+    if (report->phases.size > 0) {
+        total = usage_between(&report->phases.ptr[0].start, &report->phases.ptr[report->phases.size - 1].end);
+    }
+    // The live peak starts over with every phase, so the run's is the biggest of theirs.
+    total.peak_live_bytes = 0;
+    for (size_t i = 0; i < report->phases.size; ++i) {
+        total.peak_live_bytes = max(total.peak_live_bytes, report->phases.ptr[i].end.peak_live_bytes);
+    }
+    return total;
+}
+
+static void print_row(FILE* file, const char* name, const ResourceUsage* usage) {
+    fprintf(
+          file,
+          "%-16s %12.3f %12.3f %12llu %14llu %14llu %14llu\n",
+          name,
+          usage->wall_ns / 1e6,
+          usage->cpu_ns / 1e6,
+          (unsigned long long) usage->allocations,
+          (unsigned long long) usage->allocated_bytes / 1024,
+          (unsigned long long) usage->peak_live_bytes / 1024,
+          (unsigned long long) usage->peak_rss_bytes / 1024);
+}
+
+void time_report_print(const TimeReport* report, FILE* file) {
+    fprintf(
+          file,
+          "%-16s %12s %12s %12s %14s %14s %14s\n",
+          "phase",
+          "wall ms",
+          "cpu ms",
+          "allocs",
+          "alloc KiB",
+          "peak live KiB",
+          "max RSS KiB");
+    for (size_t i = 0; i < report->phases.size; ++i) {
+        const Phase* phase  = report->phases.ptr + i;
+        ResourceUsage usage = usage_between(&phase->start, &phase->end);
+        print_row(file, phase->name, &usage);
+    }
+    ResourceUsage total = total_usage(report);
+    print_row(file, "total", &total);
+
+    if (report->arenas.size == 0) {
+        return;
+    }
+    fprintf(
+          file,
+          "\n%-16s %12s %12s %12s %14s %14s\n",
+          "arena",
+          "count",
+          "chunk KiB",
+          "chunks",
+          "used KiB",
+          "reserved KiB");
+    for (size_t i = 0; i < report->arenas.size; ++i) {
+        const ArenaUsage* usage = report->arenas.ptr + i;
+        fprintf(
+              file,
+              "%-16s %12llu %12llu %12llu %14llu %14llu\n",
+              usage->name,
+              (unsigned long long) usage->arenas,
+              (unsigned long long) usage->chunk_size / 1024,
+              (unsigned long long) usage->chunks,
+              (unsigned long long) usage->bytes_used / 1024,
+              (unsigned long long) usage->bytes_reserved / 1024);
+    }
+}
+
+static void write_json_string(FILE* file, const char* string) {
+    fputc('"', file);
+    for (; *string; ++string) {
+        unsigned char ch = (unsigned char) *string;
+        if (ch == '"' || ch == '\\') {
+            fprintf(file, "\\%c", ch);
+        } else if (ch < 0x20) {
+            fprintf(file, "\\u%04x", ch);
+        } else {
+            fputc(ch, file);
+        }
+    }
+    fputc('"', file);
+}
+
+static void write_json_usage(FILE* file, const ResourceUsage* usage) {
+    fprintf(
+          file,
+          "\"wall_ns\": %llu, \"cpu_ns\": %llu, \"allocations\": %llu, \"allocated_bytes\": %llu, "
+          "\"peak_live_bytes\": %llu, \"peak_rss_bytes\": %llu",
+          (unsigned long long) usage->wall_ns,
+          (unsigned long long) usage->cpu_ns,
+          (unsigned long long) usage->allocations,
+          (unsigned long long) usage->allocated_bytes,
+          (unsigned long long) usage->peak_live_bytes,
+          (unsigned long long) usage->peak_rss_bytes);
+}
+
+void time_report_write_json(const TimeReport* report, const char* const* sources, size_t sources_size, FILE* file) {
+    fprintf(file, "{\n  \"version\": 1,\n  \"sources\": [");
+    for (size_t i = 0; i < sources_size; ++i) {
+        fprintf(file, i == 0 ? " " : ", ");
+        write_json_string(file, sources[i]);
+    }
+    fprintf(file, " ],\n  \"phases\": [\n");
+    for (size_t i = 0; i < report->phases.size; ++i) {
+        const Phase* phase  = report->phases.ptr + i;
+        ResourceUsage usage = usage_between(&phase->start, &phase->end);
+        fprintf(file, "    { \"name\": ");
+        write_json_string(file, phase->name);
+        fprintf(file, ", ");
+        write_json_usage(file, &usage);
+        fprintf(file, " }%s\n", i + 1 < report->phases.size ? "," : "");
+    }
+    ResourceUsage total = total_usage(report);
+    fprintf(file, "  ],\n  \"total\": { ");
+    write_json_usage(file, &total);
+    fprintf(file, " },\n  \"arenas\": [\n");
+    for (size_t i = 0; i < report->arenas.size; ++i) {
+        const ArenaUsage* usage = report->arenas.ptr + i;
+        fprintf(file, "    { \"name\": ");
+        write_json_string(file, usage->name);
+        fprintf(
+              file,
+              ", \"arenas\": %llu, \"chunk_size\": %llu, \"chunks\": %llu, \"bytes_used\": %llu, "
+              "\"bytes_reserved\": %llu }%s\n",
+              (unsigned long long) usage->arenas,
+              (unsigned long long) usage->chunk_size,
+              (unsigned long long) usage->chunks,
+              (unsigned long long) usage->bytes_used,
+              (unsigned long long) usage->bytes_reserved,
+              i + 1 < report->arenas.size ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
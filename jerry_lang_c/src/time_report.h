@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common.h"
+
+// Process-wide counters at one point in time.
+typedef struct ResourceUsage {
+    uint64 wall_ns;
+    // User and system time of every thread in the process.
+    uint64 cpu_ns;
+    // Only what goes through my_malloc/my_realloc; LLVM's own allocations show up in `peak_rss_bytes` only.
+    uint64 allocations;
+    uint64 allocated_bytes;
+    // The most my_malloc memory that was live at once since the current phase started.
+    uint64 peak_live_bytes;
+    // High-water mark of the resident set since the process started, so it can't go down from one phase to the
+    // next.
+    uint64 peak_rss_bytes;
+} ResourceUsage;
+
+void resource_usage_now(ResourceUsage* usage);
+
+typedef struct Phase {
+    const char* name;
+    ResourceUsage start;
+    ResourceUsage end;
+} Phase;
+
+VECTOR_OF(Phase, Phase);
+
+// How full the arenas of one kind were when they were reported, to pick chunk sizes from real numbers.
+typedef struct ArenaUsage {
+    const char* name;
+    uint64 arenas;
+    uint64 chunk_size;
+    uint64 chunks;
+    // What was asked for, without alignment padding or the unused tail of each chunk.
+    uint64 bytes_used;
+    uint64 bytes_reserved;
+} ArenaUsage;
+
+VECTOR_OF(ArenaUsage, ArenaUsage);
+
+// Splits a compilation into consecutive phases and records what each one cost. A NULL report turns every call
+// into a no-op, so callers don't need to check whether reporting is on.
+typedef struct TimeReport {
+    VectorPhase phases;
+    bool in_phase;
+    VectorArenaUsage arenas;
+} TimeReport;
+
+void time_report_create(TimeReport* report);
+void time_report_delete(TimeReport* report);
+
+// Ends the current phase, if any, and starts `name`. `name` has to outlive the report.
+void time_report_phase(TimeReport* report, const char* name);
+void time_report_finish(TimeReport* report);
+
+// Adds `arena` to the row called `name`, so arenas of one kind, like the one every file gets, are summed up.
+// `name` has to outlive the report.
+void time_report_arena(TimeReport* report, const char* name, const Arena* arena);
+
+// A table for people.
+void time_report_print(const TimeReport* report, FILE* file);
+// One JSON object with `phases` and `arenas` arrays, for tools tracking compile times across builds.
+void time_report_write_json(const TimeReport* report, const char* const* sources, size_t sources_size, FILE* file);
@@ -0,0 +1,53 @@
+#include "writer.h"
+
+void writer_create(Writer* writer, FILE* file, size_t capacity) {
+    writer->file     = file;
+    writer->buffer   = my_malloc(capacity);
+    writer->size     = 0;
+    writer->capacity = capacity;
+}
+
+void writer_delete(Writer* writer) {
+    writer_flush(writer);
+    my_free(writer->buffer);
+    writer->buffer = NULL;
+}
+
+void writer_flush(Writer* writer) {
+    fwrite(writer->buffer, 1, writer->size, writer->file);
+    fflush(writer->file);
+    writer->size = 0;
+}
+
+void writer_write(Writer* writer, const char* data, size_t size) {
+    if (writer->size + size > writer->capacity) {
+        writer_flush(writer);
+        if (size > writer->capacity) {
+            fwrite(data, 1, size, writer->file);
+            return;
+        }
+    }
+    memcpy(writer->buffer + writer->size, data, size);
+    writer->size += size;
+}
+
+void writer_string(Writer* writer, const char* string) {
+    writer_write(writer, string, strlen(string));
+}
+
+void writer_char(Writer* writer, char ch) {
+    if (writer->size == writer->capacity) {
+        writer_flush(writer);
+    }
+    writer->buffer[writer->size++] = ch;
+}
+
+void writer_uint(Writer* writer, uint64 number) {
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[sizeof(digits) - ++count] = (char) ('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    writer_write(writer, digits + sizeof(digits) - count, count);
+}
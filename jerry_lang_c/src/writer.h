@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common.h"
+
+enum { WRITER_BUFFER_SIZE = 256 * 1024 };
+
+// Collects output in one big buffer and hands it to the file only when the buffer is full or flushed, so dumping
+// a large input costs a few fwrite calls instead of one printf per line.
+typedef struct Writer {
+    FILE* file;
+    char* buffer;
+    size_t size;
+    size_t capacity;
+} Writer;
+
+void writer_create(Writer* writer, FILE* file, size_t capacity);
+// Flushes whatever is still buffered.
+void writer_delete(Writer* writer);
+void writer_flush(Writer* writer);
+
+void writer_write(Writer* writer, const char* data, size_t size);
+void writer_string(Writer* writer, const char* string);
+void writer_char(Writer* writer, char ch);
+void writer_uint(Writer* writer, uint64 number);
@@ -1,2 +1,2 @@
-llc code.ll -filetype=obj -o code.obj
+jerry_lang_c input.jerry -O2 -o code.obj
 cl /EHsc /DEBUG /Z7 /LD code.obj std.cpp
\ No newline at end of file
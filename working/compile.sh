@@ -0,0 +1,2 @@
+jerry_lang_c input.jerry -O2 -o code.o
+c++ -shared -fPIC code.o std.cpp -o code.so
@@ -1,4 +1,11 @@
 #include <cstdio>
+#include <cstdint>
+
+#ifdef _WIN32
+#    define EXPORT __declspec(dllexport)
+#else
+#    define EXPORT __attribute__((visibility("default")))
+#endif
 
 extern "C" {
     
@@ -6,14 +13,14 @@ void println_string(const char* string) {
     printf("%s\n", string);
 }
 
-void println_number(__int64 number) {
+void println_number(int64_t number) {
     long long n = number;
-    printf("%llu\n", n);
+    printf("%lld\n", n);
 }
 
 void salut();
 
-__declspec(dllexport) void do_thing() {
+EXPORT void do_thing() {
     salut();
 }
 